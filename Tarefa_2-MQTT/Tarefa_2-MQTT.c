@@ -2,11 +2,14 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
-#include "hardware/adc.h"
+#include "adc_sampler.h"
+#include "joystick.h"
+#include "mailbox.h"
+#include "temperature.h"
 #include "hardware/clocks.h"
 #include "hardware/gpio.h"
 #include "hardware/i2c.h"
-#include "lib/ssd1306.h"
+#include "ssd1306_widget.h"
 #include <string.h>
 #include "pico/stdlib.h"
 #include "pico/cyw43_arch.h"
@@ -18,15 +21,16 @@
 const uint LED_GREEN = 11;
 const uint I2C_SDA = 14;
 const uint I2C_SCL = 15;
-const int VRX = 26;
-const int VRY = 27;
+const uint JOY_Y_INPUT = 0; // Entrada do ADC do eixo Y (GPIO 26)
+const uint JOY_X_INPUT = 1; // Entrada do ADC do eixo X (GPIO 27)
 
-uint8_t ssd[ssd1306_buffer_length];
-struct render_area frame_area = {
-    .start_column = 0,
-    .end_column = ssd1306_width - 1,
-    .start_page = 0,
-    .end_page = ssd1306_n_pages - 1};
+ssd1306_t display;
+
+// Taxa máxima de atualização do display; mudanças mais rápidas são agrupadas num único quadro
+#define DISPLAY_MAX_FPS 20
+
+// Amostras por segundo de cada entrada do ADC; as leituras são médias de adc_sampler_block amostras
+#define ADC_SAMPLE_RATE_HZ 1000
 
 // ===== CONFIGURAÇÕES DO WIFI=====
 #define WIFI_SSID "iPhone (2)"
@@ -50,81 +54,117 @@ bool mqtt_connected = false;
 
 // ===== TEMPERATURA ===== 
 
+// Retrato do estado exibido, em binário: os textos só são montados nas bordas
+// (display e MQTT).
+// Cada campo vem da sua caixa de correio, escrita por uma única tarefa
 typedef struct
 {
-    float temperature;
-    char movement[16];
+    int16_t temperature; // Centésimos de grau (-327,68 a 327,67 °C)
+    uint8_t movement;    // joystick_direction_t, ou MOVEMENT_NONE antes do primeiro movimento
+    uint32_t sequence;   // Muda a cada escrita em qualquer campo: o display ignora estados já desenhados
 } screenInfo;
 
-QueueHandle_t displayQueue;
+#define MOVEMENT_NONE joystick_directions
+
+mailbox_t temperatureBox; // int16_t, escrito só por vSensorTask
+mailbox_t movementBox;    // uint8_t, escrito só por vjoystick
+TaskHandle_t displayTaskHandle; // Notificada a cada escrita nas caixas
+
+QueueHandle_t joystickQueue; // Última direção do joystick, escrita pela interrupção do ADC
+
+// Seta exibida para cada direção do joystick
+static const ssd1306_arrow_t direction_arrows[joystick_directions + 1] = {
+    [joystick_center] = ssd1306_arrow_none,
+    [joystick_up] = ssd1306_arrow_up,
+    [joystick_up_right] = ssd1306_arrow_up_right,
+    [joystick_right] = ssd1306_arrow_right,
+    [joystick_down_right] = ssd1306_arrow_down_right,
+    [joystick_down] = ssd1306_arrow_down,
+    [joystick_down_left] = ssd1306_arrow_down_left,
+    [joystick_left] = ssd1306_arrow_left,
+    [joystick_up_left] = ssd1306_arrow_up_left,
+    [MOVEMENT_NONE] = ssd1306_arrow_none,
+};
+
+// Legenda exibida para cada movimento do joystick
+static const char *movement_name(uint8_t movement)
+{
+    return movement == MOVEMENT_NONE ? "" : joystick_direction_name(movement);
+}
+
+// Temperatura em centésimos no formato de screenInfo, saturada nos limites de 16 bits
+static int16_t temperature_centi16(int32_t centi)
+{
+    if (centi > INT16_MAX)
+        return INT16_MAX;
+    if (centi < INT16_MIN)
+        return INT16_MIN;
+    return (int16_t)centi;
+}
+
+// Lê o estado atual sem travar os escritores: cada campo é uma cópia consistente do seu último valor
+static void read_screen_info(screenInfo *info)
+{
+    info->sequence = mailbox_read(&temperatureBox, &info->temperature);
+    info->sequence += mailbox_read(&movementBox, &info->movement);
+}
 
-// ===== FUNÇÃO PARA LER A TEMPERATURA DO SENSOR INTERNO =====
-float read_onboard_temperature()
+// Chamada na interrupção do DMA quando a direção do joystick muda. A fila tem uma posição e é
+// sobrescrita: se a tarefa ainda não leu a direção anterior, só a mais recente importa
+static void joystick_changed(joystick_direction_t direction, void *user_data)
 {
-    const float conversion_factor = 3.3f / (1 << 12);
-    adc_select_input(4);
-    uint16_t raw = adc_read();
-    float voltage = raw * conversion_factor;
-    return 27.0f - (voltage - 0.706f) / 0.001721f;
+    BaseType_t woken = pdFALSE;
+    xQueueOverwriteFromISR(joystickQueue, &direction, &woken);
+    portYIELD_FROM_ISR(woken);
 }
 
 // ===== TAREFA PARA ATAUALIZAR O DISPLAY OLED =====
 void vdisplayTask(void *pvParameters)
 {
     screenInfo data;
-    for (;;)
-    {
-        if (xQueuePeek(displayQueue, &data, pdMS_TO_TICKS(100)) == pdTRUE)
-        {
-            memset(ssd, 0, ssd1306_buffer_length);
-
-            char tempStr[20];
-            snprintf(tempStr, sizeof(tempStr), " %.1f°C", data.temperature);
+    bool drawn = false;
+    uint32_t drawn_sequence = 0;
+    ssd1306_widget_t tempLabel, tempValue, joystickLabel, movementArrow;
 
-            ssd1306_draw_line(ssd, 10, 0, 110, 0, true);
-            ssd1306_draw_line(ssd, 110, 0, 110, 15, true);
-            ssd1306_draw_line(ssd, 10, 0, 10, 15, true);
-            ssd1306_draw_line(ssd, 10, 15, 110, 15, true);
+    // Moldura e rótulos fixos são desenhados uma única vez
+    ssd1306_label_init(&tempLabel, 15, 5, "Temperatura:", 1);
+    ssd1306_value_init_font(&tempValue, 28, 18, ssd1306_width - 28, 1, "°C", &ssd1306_font_num16);
+    ssd1306_label_init(&joystickLabel, 25, 39, "Joystick:", 1);
+    ssd1306_arrow_init(&movementArrow, 25, 54, ssd1306_width - 25);
 
-            ssd1306_draw_string_scaled(ssd, 15, 5, "Temperatura:", 1);
-            ssd1306_draw_string_scaled(ssd, 25, 20, tempStr, 1);
+    ssd1306_rect(&display, 10, 0, 101, 16, true);
+    ssd1306_label_draw(&display, &tempLabel);
+    ssd1306_rect(&display, 20, 35, 81, 15, true);
+    ssd1306_label_draw(&display, &joystickLabel);
+    ssd1306_send_data(&display);
 
-            ssd1306_draw_line(ssd, 20, 35, 100, 35, true);
-            ssd1306_draw_line(ssd, 100, 35, 100, 49, true);
-            ssd1306_draw_line(ssd, 20, 35, 20, 49, true);
-            ssd1306_draw_line(ssd, 20, 49, 100, 49, true);
+    const TickType_t frame_ticks = pdMS_TO_TICKS(1000 / DISPLAY_MAX_FPS);
 
-            ssd1306_draw_string_scaled(ssd, 25, 39, "Joystick:", 1);
-            ssd1306_draw_string_scaled(ssd, 25, 55, data.movement, 1);
+    for (;;)
+    {
+        read_screen_info(&data);
+        if (!drawn || data.sequence != drawn_sequence)
+        {
+            // Os widgets só redesenham o que mudou; sem mudanças nada é enviado
+            ssd1306_value_set(&display, &tempValue, temperature_round(data.temperature, 10));
+            ssd1306_arrow_set(&display, &movementArrow, movement_name(data.movement), direction_arrows[data.movement]);
+            render_dirty_on_display(&display);
+            drawn = true;
+            drawn_sequence = data.sequence;
+        }
+        TickType_t last_frame = xTaskGetTickCount();
 
-            if (strcmp(data.movement, "Cima") == 0)
-            {
-                ssd1306_draw_line(ssd, 70, 60, 70, 55, true);
-                ssd1306_draw_line(ssd, 70, 52, 67, 55, true);
-                ssd1306_draw_line(ssd, 70, 52, 73, 55, true);
-            }
-            else if (strcmp(data.movement, "Baixo") == 0)
-            {
-                ssd1306_draw_line(ssd, 75, 63, 75, 55, true);
-                ssd1306_draw_line(ssd, 75, 63, 72, 60, true);
-                ssd1306_draw_line(ssd, 75, 63, 78, 60, true);
-            }
+        // Dorme até que a temperatura ou o joystick mudem
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
 
-            else if (strcmp(data.movement, "Esquerda") == 0)
-            {
-                ssd1306_draw_line(ssd, 95, 58, 103, 58, true);
-                ssd1306_draw_line(ssd, 95, 58, 98, 55, true);
-                ssd1306_draw_line(ssd, 95, 58, 98, 61, true);
-            }
-            else if (strcmp(data.movement, "Direita") == 0)
-            {
-                ssd1306_draw_line(ssd, 90, 58, 98, 58, true);
-                ssd1306_draw_line(ssd, 95, 55, 98, 58, true);
-                ssd1306_draw_line(ssd, 95, 61, 98, 58, true);
-            }
-            render_on_display(ssd, &frame_area);
+        // Respeita o intervalo mínimo entre quadros; as notificações recebidas nesse meio
+        // tempo são descartadas e o próximo quadro mostra apenas o estado mais recente
+        TickType_t elapsed = xTaskGetTickCount() - last_frame;
+        if (elapsed < frame_ticks)
+        {
+            vTaskDelay(frame_ticks - elapsed);
         }
-        vTaskDelay(pdMS_TO_TICKS(200));
+        ulTaskNotifyTake(pdTRUE, 0);
     }
 }
 // ===== CALLBACKS MQTT =====
@@ -178,52 +218,54 @@ void dns_found_cb(const char *name, const ip_addr_t *ipaddr, void *callback_arg)
 // ===== t
 void vjoystick(void *pvParameters)
 {
-    char ultimaDirecao[16] = "";
+    uint8_t movement = MOVEMENT_NONE; // Valor de movementBox: só esta tarefa escreve nela
+    uint8_t ultimaDirecao = MOVEMENT_NONE;
 
     for (;;)
     {
-        adc_select_input(0); // Y
-        uint adc_y_raw = adc_read();
-        adc_select_input(1); // X
-        uint adc_x_raw = adc_read();
+        // Dorme até a interrupção do ADC detectar uma nova direção; enquanto houver uma direção
+        // ainda não publicada (MQTT desconectado), acorda a cada 100 ms para tentar de novo
+        joystick_direction_t direction;
+        TickType_t wait = movement != ultimaDirecao ? pdMS_TO_TICKS(100) : portMAX_DELAY;
+        if (xQueueReceive(joystickQueue, &direction, wait) == pdTRUE)
+        {
+            movement = direction;
+            mailbox_write(&movementBox, &movement);
+            xTaskNotifyGive(displayTaskHandle);
+        }
 
-        screenInfo data;
-        if (xQueuePeek(displayQueue, &data, pdMS_TO_TICKS(50)) == pdTRUE)
+        // Publica no MQTT somente se a direção mudou
+        if (mqtt_connected && movement != ultimaDirecao && mqtt_ready_to_publish != 0)
         {
+            char msg[32];
+            snprintf(msg, sizeof(msg), "%s", movement_name(movement));
 
-            if (adc_y_raw < 500)
-                strcpy(data.movement, "Baixo");
-            else if (adc_y_raw > 3000)
-                strcpy(data.movement, "Cima");
-            else if (adc_x_raw < 500)
-                strcpy(data.movement, "Esquerda");
-            else if (adc_x_raw > 3000)
-                strcpy(data.movement, "Direita");
-
-            xQueueOverwrite(displayQueue, &data);
-            // Publica no MQTT somente se a direção mudou
-            if (mqtt_connected && strcmp(data.movement, ultimaDirecao) && mqtt_ready_to_publish != 0)
+            err_t err = mqtt_publish(client, MQTT_TOPIC_JOY, msg, strlen(msg), 0, 1, NULL, NULL);
+            if (err == ERR_OK)
             {
-                char msg[32];
-                snprintf(msg, sizeof(msg), "%s", data.movement);
-
-                err_t err = mqtt_publish(client, MQTT_TOPIC_JOY, msg, strlen(msg), 0, 1, NULL, NULL);
-                if (err == ERR_OK)
-                {
-                    printf("Joystick publicado: %s\n", msg);
+                printf("Joystick publicado: %s\n", msg);
 
-                    gpio_put(LED_GREEN, 1);    // ACENDE O LED VERDE
-                    vTaskDelay(pdMS_TO_TICKS(50)); // ESPERA 50 ms
-                    gpio_put(LED_GREEN, 0);    // APAGA O LED VERDE
-                }
+                gpio_put(LED_GREEN, 1);    // ACENDE O LED VERDE
+                vTaskDelay(pdMS_TO_TICKS(50)); // ESPERA 50 ms
+                gpio_put(LED_GREEN, 0);    // APAGA O LED VERDE
+            }
 
-                else
-                    printf("Erro ao publicar joystick: %d\n", err);
+            else
+                printf("Erro ao publicar joystick: %d\n", err);
 
-                strcpy(ultimaDirecao, data.movement);
-            }
+            ultimaDirecao = movement;
         }
+    }
+}
 
+// ===== TAREFA DE CALIBRAÇÃO PELA SERIAL =====
+// Atende os comandos "cal" e "cal <graus>" (temperature_calibration_poll) sem ocupar a CPU
+// enquanto nada chega
+void vCalibrationTask(void *pvParameters)
+{
+    for (;;)
+    {
+        temperature_calibration_poll();
         vTaskDelay(pdMS_TO_TICKS(100));
     }
 }
@@ -236,18 +278,24 @@ void vSensorTask(void *pvParameters)
     for (;;)
     {
        
-        float temp = read_onboard_temperature();
+        int32_t temp = temperature_read_centi();
 
-        screenInfo data;
-        if (xQueuePeek(displayQueue, &data, pdMS_TO_TICKS(50)) == pdTRUE && mqtt_connected)
+        if (mqtt_connected)
         {
-            data.temperature = temp;
-            xQueueOverwrite(displayQueue, &data);
+            // Só acorda o display se o valor exibido (em décimos de grau) mudou
+            int16_t shown;
+            mailbox_read(&temperatureBox, &shown);
+            if (temperature_round(temp, 10) != temperature_round(shown, 10))
+            {
+                shown = temperature_centi16(temp);
+                mailbox_write(&temperatureBox, &shown);
+                xTaskNotifyGive(displayTaskHandle);
+            }
 
             if (mqtt_ready_to_publish && mqtt_connected && mqtt_ready_to_publish != 0)
             {
                 char msg[64];
-                snprintf(msg, sizeof(msg), " %.0f", data.temperature);
+                snprintf(msg, sizeof(msg), " %ld", (long)temperature_round(shown, 100));
                 err_t err = mqtt_publish(client, MQTT_TOPIC_TEMP, msg, strlen(msg), 0, 1, NULL, NULL);
                 if (err == ERR_OK)
                 {
@@ -274,13 +322,9 @@ int main()
     gpio_init(LED_GREEN);
     gpio_set_dir(LED_GREEN, GPIO_OUT);
 
-    // Inicialização do ADC (joystick + temperatura)
-    adc_init();
-    adc_gpio_init(VRX);
-    adc_gpio_init(VRY);
-
-    // Leitura do sensor
-    adc_set_temp_sensor_enabled(true);
+    // Aquisição contínua do ADC (joystick + temperatura) por DMA, sem disputa pelo multiplexador
+    adc_sampler_init((1u << JOY_Y_INPUT) | (1u << JOY_X_INPUT) | (1u << adc_sampler_temperature_input), ADC_SAMPLE_RATE_HZ);
+    temperature_init(temperature_filter_shift_default);
 
     // Inicialização do I2C e display
     i2c_init(i2c1, ssd1306_i2c_clock * 1000);
@@ -288,20 +332,25 @@ int main()
     gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
     gpio_pull_up(I2C_SDA);
     gpio_pull_up(I2C_SCL);
-    ssd1306_init();
-    calculate_render_area_buffer_length(&frame_area);
+    ssd1306_init(&display, ssd1306_width, ssd1306_height, false, ssd1306_i2c_address, i2c1);
+
+    // Valores iniciais do estado compartilhado
+    int16_t initial_temperature = 0;
+    uint8_t initial_movement = MOVEMENT_NONE;
+    mailbox_init(&temperatureBox, sizeof(initial_temperature), &initial_temperature);
+    mailbox_init(&movementBox, sizeof(initial_movement), &initial_movement);
 
     // Criação da fila
-    displayQueue = xQueueCreate(1, sizeof(screenInfo));
-    if (displayQueue == NULL)
+    joystickQueue = xQueueCreate(1, sizeof(joystick_direction_t));
+    if (joystickQueue == NULL)
     {
         printf("Não foi possivel criar fila.\n");
         while (1)
             ;
     }
-    // Primeiro valor da fila
-    screenInfo init_data = {.temperature = 0.0f, .movement = ""};
-    xQueueOverwrite(displayQueue, &init_data);
+    // A partir daqui a interrupção do ADC envia as mudanças de direção para joystickQueue
+    // (a posição atual é tomada como centro: o joystick deve estar solto)
+    joystick_init(JOY_X_INPUT, JOY_Y_INPUT, joystick_deadzone_default, joystick_hysteresis_default, joystick_changed, NULL);
 
     printf("Inicializando Wi-Fi + MQTT\n");
 
@@ -338,7 +387,8 @@ int main()
     // Criação das tarefas
     xTaskCreate(vSensorTask, "Sensor Task", 256, NULL, 1, NULL);
     xTaskCreate(vjoystick, "Joystick Task", 256, NULL, 1, NULL);
-    xTaskCreate(vdisplayTask, "Display Task", 256, NULL, 1, NULL);
+    xTaskCreate(vdisplayTask, "Display Task", 256, NULL, 1, &displayTaskHandle);
+    xTaskCreate(vCalibrationTask, "Calibration Task", 512, NULL, 1, NULL); // Página da flash e printf na pilha
     
 
     // Inicia o escalonador do FreeRTOS
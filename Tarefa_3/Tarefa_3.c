@@ -8,8 +8,11 @@
 #include "lwip/apps/mqtt.h"
 #include "lwip/dns.h"
 #include "lwip/ip_addr.h"
-#include "lib/ssd1306.h"
+#include "ssd1306_widget.h"
 #include "inc/mpu6050_handler.h"
+#include "inc/imu_fusion.h"
+#include "inc/imu_stats.h"
+#include "inc/imu_fft.h"
 #include "inc/ntp_client.h"
 
 // ===== DEFINIÇÕES DOS PINOS =====
@@ -18,6 +21,18 @@
 #define I2C1_SDA 14
 #define I2C1_SCL 15
 #define LED_PIN_GREEN 11
+#define MPU6050_INT_PIN 16 // Pino INT do módulo MPU-6050 (data-ready)
+
+// Aquisição contínua do MPU-6050 pela FIFO (no núcleo 1, junto com a fusão de sensores)
+#define MPU6050_SAMPLE_RATE_HZ 1000
+#define ORIENTATION_PUBLISH_INTERVAL_MS 1000
+#define SPECTRUM_POINTS 1024 // Quadros de ~1 s a 1 kHz: resolução de ~1 Hz
+#define SPECTRUM_PUBLISH_INTERVAL_MS 5000
+#define STATUS_SCROLL_INTERVAL ssd1306_scroll_frames_3 // Rolagem por hardware das linhas de status (~33 px/s)
+
+// Publicação das estatísticas: mudança relevante desde a última publicação
+#define PUBLISH_MEAN_CHANGE_MG 100 // Média de algum eixo do acelerômetro deslocada (inclinação lenta)
+#define PUBLISH_MOTION_STD_MG 50   // Desvio padrão de |a| na janela (vibração ou movimento)
 
 // ===== CONFIGURAÇÕES DO WIFI=====
 #define WIFI_SSID "iPhone (2)"
@@ -31,6 +46,9 @@
 #define MQTT_PASS "desafio20.laica"
 #define MQTT_CLIENT_ID "anderson.dantas"
 #define MQTT_TOPIC_MP6050 "ha/desafio20/anderson.dantas/mpu6050"
+#define MQTT_TOPIC_ORIENTATION MQTT_TOPIC_MP6050 "/orientation"
+#define MQTT_TOPIC_EVENT MQTT_TOPIC_MP6050 "/event"
+#define MQTT_TOPIC_SPECTRUM MQTT_TOPIC_MP6050 "/spectrum"
 #define NUMERO_DESAFIO "20"
 
 // ===== VARIÁVEIS GLOBAIS =====
@@ -40,58 +58,111 @@ bool mqtt_connected = false;
 volatile bool time_synchronized = false;
 volatile time_t current_utc_time = 0;
 #define NTP_SERVER "pool.ntp.br" // Servidor NTP do Brasil
+ssd1306_t display;
+
+// Widgets da tela de dados do sensor (redesenhados apenas quando o valor muda)
+ssd1306_widget_t accel_value[3], gyro_value[3], temp_value;
+bool dashboard_drawn = false; // false: a tela foi usada por outra mensagem e precisa ser refeita
 
 // ===== FUNÇÃO PARA ATAUALIZAR O DISPLAY OLED  AO INICIAR =====
+// Linhas mais largas que a tela viram letreiros. Se todas cabem na GDDRAM o próprio controlador
+// as gira (comandos 0x26/0x27), sem tráfego I2C; senão display_message_step as desloca
+ssd1306_widget_t status_lines[4];
+bool status_hardware_scroll = false; // As linhas de status estão girando no controlador
+
 void display_message_init(const char *line1, const char *line2, const char *line3, const char *line4)
 {
-    // Cria área de renderização que cobre toda a tela
-    struct render_area area = {0, ssd1306_width - 1, 0, ssd1306_n_pages - 1};
-    calculate_render_area_buffer_length(&area);
-    uint8_t buffer[ssd1306_buffer_length];
-    memset(buffer, 0, sizeof(buffer));// Limpa o buffer antes de desenhar
+    static const int line_x[4] = {5, 5, 0, 0};
+    static const int line_y[4] = {0, 16, 32, 48};
+    const char *lines[4] = {line1, line2, line3, line4};
+
+    ssd1306_clear(&display); // Limpa o buffer antes de desenhar
+    dashboard_drawn = false;
 
     // Escreve cada linha no display (se não for NULL)
-    if (line1)
-        ssd1306_draw_string(buffer, 5 , 0, (char *)line1);
-    if (line2)
-        ssd1306_draw_string(buffer, 5, 16, (char *)line2);
-    if (line3)
-        ssd1306_draw_string(buffer, 0, 32, (char *)line3);
-    if (line4)
-        ssd1306_draw_string(buffer, 0, 48, (char *)line4);
-    render_on_display(buffer, &area);// Atualiza display com conteúdo do buffer
+    for (int i = 0; i < 4; i++)
+    {
+        ssd1306_marquee_init(&status_lines[i], line_x[i], line_y[i], ssd1306_width - line_x[i]);
+        if (lines[i])
+            ssd1306_marquee_set(&display, &status_lines[i], lines[i]);
+    }
+
+    // Atualiza display com conteúdo do buffer (encerrar a rolagem anterior já reenvia a tela)
+    if (status_hardware_scroll)
+        ssd1306_stop_scroll(&display);
+    else
+        ssd1306_send_data(&display);
+    status_hardware_scroll = ssd1306_marquee_hardware_lines(&display, status_lines, 4, STATUS_SCROLL_INTERVAL);
 }
 
-// ===== FUNÇÃO PARA ATAUALIZAR O DISPLAY OLED  =====
-void display_message(mpu6050_data_t *sensor_data)
+// ===== FUNÇÃO PARA ROLAR AS LINHAS DE STATUS =====
+// Avança os letreiros da tela de status que não puderam ir para o hardware; envia apenas as
+// páginas das linhas que rolaram
+void display_message_step(void)
 {
-    struct render_area area = {0, ssd1306_width - 1, 0, ssd1306_n_pages - 1};
-    calculate_render_area_buffer_length(&area);
-    uint8_t buffer[ssd1306_buffer_length];
-    memset(buffer, 0, sizeof(buffer));
-
-    // Converte dados do sensor em strings
-    char tempStr[20];
-    snprintf(tempStr, sizeof(tempStr), "Temp: %.1f °C", sensor_data->temperature);
-
-    char accel_giros_x[40];
-    snprintf(accel_giros_x, sizeof(accel_giros_x), "X: %.2f   %4.2f", sensor_data->accel_x, sensor_data->gyro_x);
+    if (dashboard_drawn)
+        return;
+
+    bool moved = false;
+    for (int i = 0; i < 4; i++)
+        moved |= ssd1306_marquee_step(&display, &status_lines[i], 2);
+    if (moved)
+        render_dirty_on_display(&display);
+}
 
-    char accel_giros_y[40];
-    snprintf(accel_giros_y, sizeof(accel_giros_y), "y: %.2f   %4.2f", sensor_data->accel_y, sensor_data->gyro_y);
+// Para telas de erro finais: sem o laço principal, a linha que rola passa para o hardware do display
+void display_message_halt(void)
+{
+    if (status_hardware_scroll)
+        return;
+    for (int i = 0; i < 4; i++)
+        if (ssd1306_marquee_hardware(&display, &status_lines[i], ssd1306_scroll_frames_5))
+            break;
+}
 
-    char accel_giros_z[40];
-    snprintf(accel_giros_z, sizeof(accel_giros_z), "z: %.2f   %4.2f", sensor_data->accel_z, sensor_data->gyro_z);
+// ===== FUNÇÃO PARA ATAUALIZAR O DISPLAY OLED  =====
+void display_message(mpu6050_data_t *sensor_data)
+{
+    // Cabeçalho, rótulos e linha divisória só são desenhados quando a tela é refeita
+    if (!dashboard_drawn)
+    {
+        static const char *axis[3] = {"X:", "Y:", "Z:"};
+        static const int row[3] = {16, 32, 45};
+
+        ssd1306_clear(&display);
+        ssd1306_draw_string(&display, 10, 0, "ACEL.");
+        ssd1306_draw_string(&display, 70, 0, "GIROS.");
+        ssd1306_draw_line(&display, 0, 12, 150, 12, true);
+        for (int i = 0; i < 3; i++)
+        {
+            ssd1306_draw_string(&display, 0, row[i], axis[i]);
+            ssd1306_value_init(&accel_value[i], 24, row[i], 48, 2, NULL, 1);
+            ssd1306_value_init(&gyro_value[i], 72, row[i], ssd1306_width - 72, 2, NULL, 1);
+        }
+        ssd1306_draw_string(&display, 0, 56, "Temp:");
+        ssd1306_value_init(&temp_value, 48, 56, ssd1306_width - 48, 1, " °C", 1);
+        dashboard_drawn = true;
 
-    ssd1306_draw_string(buffer, 10, 0, "ACEL.");
-    ssd1306_draw_string(buffer, 70, 0, "GIROS.");
-    ssd1306_draw_line(buffer, 0, 12, 150, 12, true);
-    ssd1306_draw_string(buffer, 0, 16, accel_giros_x);
-    ssd1306_draw_string(buffer, 0, 32, accel_giros_y);
-    ssd1306_draw_string(buffer, 0, 45, accel_giros_z);
-    ssd1306_draw_string(buffer, 0, 56, tempStr);
+        // O painel não rola: encerrar a rolagem das linhas de status já envia a tela nova
+        if (status_hardware_scroll)
+        {
+            ssd1306_stop_scroll(&display);
+            status_hardware_scroll = false;
+        }
+    }
 
-    render_on_display(buffer, &area);
+    // Valores em centésimos (décimos para a temperatura); só os campos alterados são redesenhados
+    ssd1306_value_set(&display, &accel_value[0], lroundf(sensor_data->accel_x * 100.0f));
+    ssd1306_value_set(&display, &accel_value[1], lroundf(sensor_data->accel_y * 100.0f));
+    ssd1306_value_set(&display, &accel_value[2], lroundf(sensor_data->accel_z * 100.0f));
+    ssd1306_value_set(&display, &gyro_value[0], lroundf(sensor_data->gyro_x * 100.0f));
+    ssd1306_value_set(&display, &gyro_value[1], lroundf(sensor_data->gyro_y * 100.0f));
+    ssd1306_value_set(&display, &gyro_value[2], lroundf(sensor_data->gyro_z * 100.0f));
+    ssd1306_value_set(&display, &temp_value, lroundf(sensor_data->temperature * 10.0f));
+
+    // Envio por DMA: o laço principal segue atendendo o Wi-Fi e o sensor durante a transferência
+    if (ssd1306_is_dirty(&display))
+        render_on_display_async(&display, NULL, NULL);
 }
 
 // ===== CALLBACKS MQTT =====
@@ -109,6 +180,21 @@ void mqtt_connection_cb(mqtt_client_t *client, void *arg, mqtt_connection_status
     }
 }
 
+// ===== DECISÃO DE PUBLICAÇÃO =====
+// Compara as estatísticas da janela com as da última publicação
+bool stats_changed(const imu_stats_summary_t *now, const imu_stats_summary_t *last)
+{
+    for (int channel = IMU_STATS_ACCEL_X; channel <= IMU_STATS_ACCEL_Z; channel++)
+    {
+        int32_t shift_mg = imu_stats_scale(channel, now->channel[channel].mean - last->channel[channel].mean);
+        if (shift_mg > PUBLISH_MEAN_CHANGE_MG || shift_mg < -PUBLISH_MEAN_CHANGE_MG)
+        {
+            return true;
+        }
+    }
+    return imu_stats_scale(IMU_STATS_ACCEL_MAGNITUDE, now->channel[IMU_STATS_ACCEL_MAGNITUDE].std) > PUBLISH_MOTION_STD_MG;
+}
+
 // ===== CALLBACK DE RESOLUÇÃO DNS =====
 void dns_found_cb(const char *name, const ip_addr_t *ipaddr, void *callback_arg)
 {
@@ -153,6 +239,15 @@ int main()
     {
         printf("Falha ao inicializar o MPU6050!\n");
     }
+    else
+    {
+        // Daqui em diante o núcleo 1 é o dono do MPU: FIFO, pino INT e i2c0
+        static const imu_stats_config_t stats_config = IMU_STATS_DEFAULT_CONFIG;
+        imu_stats_init(&stats_config, MPU6050_SAMPLE_RATE_HZ);
+        static const uint16_t band_edges[IMU_FFT_BANDS + 1] = IMU_FFT_DEFAULT_BAND_EDGES;
+        imu_fft_init(SPECTRUM_POINTS, MPU6050_SAMPLE_RATE_HZ, band_edges);
+        imu_fusion_start(MPU6050_INT_PIN, MPU6050_SAMPLE_RATE_HZ, DLPF_184_HZ);
+    }
 
     // === INICIALIZA I2C1 PARA DISPLAY OLED ===
     i2c_init(i2c1, 400 * 1000);
@@ -160,7 +255,8 @@ int main()
     gpio_set_function(I2C1_SCL, GPIO_FUNC_I2C);
     gpio_pull_up(I2C1_SDA);
     gpio_pull_up(I2C1_SCL);
-    ssd1306_init(i2c1);
+    ssd1306_init(&display, ssd1306_width, ssd1306_height, false, ssd1306_i2c_address, i2c1);
+    ssd1306_async_init(&display);
 
     // === CONFIGURA LED INDICADOR ===
     gpio_init(LED_PIN_GREEN);
@@ -171,6 +267,7 @@ int main()
     if (cyw43_arch_init())
     {
         display_message_init("ERRO", " no driver Wi-Fi", NULL, NULL);
+        display_message_halt();
         return -1;
     }
 
@@ -178,6 +275,7 @@ int main()
     if (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 30000))
     {
         display_message_init("ERRO", "WiFi Nao Conecta", NULL, NULL);
+        display_message_halt();
         return -1;
     }
 
@@ -189,33 +287,129 @@ int main()
     absolute_time_t last_sensor_read = get_absolute_time();
     absolute_time_t last_ntp_sync = get_absolute_time();
     absolute_time_t last_publish_time = get_absolute_time();
+    absolute_time_t last_orientation_publish = get_absolute_time();
+    absolute_time_t last_spectrum_publish = get_absolute_time();
+    uint32_t last_spectrum = 0; // Sequência do último espectro publicado
     ;
-    mpu6050_data_t last_published_data = {0};
+    imu_stats_summary_t last_published_stats = {0};
+    imu_events_t last_events = {0};
+    mpu6050_raw_t latest_sample; // Amostra mais recente processada pelo núcleo 1
 
     while (1)
     {
         cyw43_arch_poll();// Mantém Wi-Fi e TCP/IP funcionando
 
+        // === ORIENTAÇÃO (fusão no núcleo 1) ===
+        // Payload compacto num tópico próprio, só depois da calibração e da convergência
+        if (imu_fusion_status() == IMU_FUSION_RUNNING &&
+            absolute_time_diff_us(last_orientation_publish, get_absolute_time()) >= ORIENTATION_PUBLISH_INTERVAL_MS * 1000)
+        {
+            last_orientation_publish = get_absolute_time();
+            if (mqtt_connected && mqtt_client_is_connected(client))
+            {
+                imu_orientation_t orientation;
+                char payload[64];
+                imu_fusion_read(&orientation);
+                int length = imu_fusion_format(payload, sizeof(payload), &orientation);
+                if (mqtt_publish(client, MQTT_TOPIC_ORIENTATION, payload, length, 0, 0, NULL, NULL) != ERR_OK)
+                {
+                    printf("MQTT: Erro ao publicar a orientacao.\n");
+                }
+            }
+        }
+
+        // === ESPECTRO DE VIBRAÇÃO (FFT no núcleo 1) ===
+        // Picos e energia por faixa de cada eixo, quando há um quadro novo desde a última publicação
+        if (absolute_time_diff_us(last_spectrum_publish, get_absolute_time()) >= SPECTRUM_PUBLISH_INTERVAL_MS * 1000)
+        {
+            // O intervalo recomeça a cada verificação: sem broker ou sem quadro novo, a próxima
+            // leitura das caixas só acontece no próximo intervalo
+            last_spectrum_publish = get_absolute_time();
+            imu_fft_spectrum_t spectrum;
+            uint32_t sequence = imu_fft_read(&spectrum);
+            if (sequence != last_spectrum && mqtt_connected && mqtt_client_is_connected(client))
+            {
+                static char payload[384];
+                int length = imu_fft_format(payload, sizeof(payload), &spectrum);
+                if (mqtt_publish(client, MQTT_TOPIC_SPECTRUM, payload, length, 0, 0, NULL, NULL) == ERR_OK)
+                {
+                    last_spectrum = sequence;
+                }
+                else
+                {
+                    printf("MQTT: Erro ao publicar o espectro.\n");
+                }
+            }
+        }
+
+        // === EVENTOS (choque, queda livre, inclinação) ===
+        // Publicados assim que o núcleo 1 os detecta, num tópico próprio
+        imu_events_t events;
+        imu_stats_read_events(&events);
+        if (events.shocks != last_events.shocks || events.free_falls != last_events.free_falls ||
+            events.tilts != last_events.tilts || events.tilted != last_events.tilted)
+        {
+            if (mqtt_connected && mqtt_client_is_connected(client))
+            {
+                char payload[128];
+                int length = imu_stats_format_events(payload, sizeof(payload), &events);
+                if (mqtt_publish(client, MQTT_TOPIC_EVENT, payload, length, 1, 0, NULL, NULL) == ERR_OK)
+                {
+                    printf("Evento: %s\n", imu_event_name(events.last));
+                    last_events = events;
+                }
+            }
+            else
+            {
+                last_events = events; // Sem broker, o evento só entra na próxima contagem publicada
+            }
+        }
+
         // === LEITURA DO SENSOR ===
         if (absolute_time_diff_us(last_sensor_read, get_absolute_time()) >= 1000000)
         {
             last_sensor_read = get_absolute_time();
 
             mpu6050_data_t sensor_data;
-            if (mpu6050_read_data(&sensor_data))
+            if (imu_fusion_latest_sample(&latest_sample))
             {
+                mpu6050_convert(&latest_sample, &sensor_data);
+
                 // Atualiza display com dados do sensor
                 display_message(&sensor_data);
-
-                // Publica no MQTT se houver mudança significativa ou se passou 60s
-                bool has_changed = (fabs(sensor_data.accel_x - last_published_data.accel_x) > 0.1);
+#if SSD1306_STATS
+                // Custo do display no último segundo (compilado com -DSSD1306_STATS=ON)
+                ssd1306_stats_t stats;
+                ssd1306_stats_get(&display, &stats);
+                printf("OLED: %lu bytes, %lu transacoes, %lu envios, %lu us\n",
+                       (unsigned long)stats.bytes, (unsigned long)stats.transactions,
+                       (unsigned long)stats.flushes, (unsigned long)stats.flush_us);
+                ssd1306_stats_reset(&display);
+
+                mpu6050_fifo_stats_t fifo;
+                mpu6050_fifo_get_stats(&fifo);
+                printf("MPU: %lu amostras, %lu rajadas, %lu estouros, %lu descartadas\n",
+                       (unsigned long)fifo.samples, (unsigned long)fifo.bursts,
+                       (unsigned long)fifo.overflows, (unsigned long)fifo.dropped);
+
+                imu_fft_spectrum_t spectrum;
+                imu_fft_read(&spectrum);
+                printf("FFT: %u pontos x 3 eixos em %u us\n", SPECTRUM_POINTS, spectrum.bands[0].transform_us);
+#endif
+
+                // Publica as estatísticas da janela se houver mudança significativa ou se passou 60s
+                imu_stats_summary_t window_stats;
+                imu_stats_read(&window_stats);
+                bool has_changed = stats_changed(&window_stats, &last_published_stats);
                 if ((absolute_time_diff_us(last_publish_time, get_absolute_time()) > 10e6 && has_changed) ||
                     (absolute_time_diff_us(last_publish_time, get_absolute_time()) > 60e6))
                 {
 
                     if (mqtt_connected && mqtt_client_is_connected(client))
                     {
-                        char payload[512];
+                        static char payload[1024]; // Fora da pilha (pequena) do main
+                        static char stats_json[512];
+                        char events_json[128];
                         char timestamp_str[20];
 
                         // Se tempo foi sincronizado, gera timestamp
@@ -246,14 +440,15 @@ int main()
                             strcpy(timestamp_str, "1970-01-01T00:00:00");
                         }
 
-                        // Monta JSON para publicação no MQTT
+                        // Monta JSON para publicação no MQTT: estatísticas da janela (mg e mdps),
+                        // contadores de eventos e a temperatura da amostra mais recente
+                        imu_stats_format(stats_json, sizeof(stats_json), &window_stats);
+                        imu_stats_format_events(events_json, sizeof(events_json), &events);
                         snprintf(payload, sizeof(payload),
-                                 "{\"team\":\"desafio%s\",\"device\":\"bitdoglab_%s\",\"ip\":\"%s\",\"ssid\":\"%s\",\"sensor\":\"MPU-6050\",\"data\":{\"accel\":{\"x\":%.2f,\"y\":%.2f,\"z\":%.2f},\"gyro\":{\"x\":%.2f,\"y\":%.2f,\"z\":%.2f},\"temperature\":%.1f},\"timestamp\":\"%s\"}",
+                                 "{\"team\":\"desafio%s\",\"device\":\"bitdoglab_%s\",\"ip\":\"%s\",\"ssid\":\"%s\",\"sensor\":\"MPU-6050\",\"data\":{\"stats\":%s,\"events\":%s,\"temperature\":%.1f},\"timestamp\":\"%s\"}",
                                  NUMERO_DESAFIO, SEU_NOME,
                                  ip4addr_ntoa(netif_ip4_addr(netif_default)), WIFI_SSID,
-                                 sensor_data.accel_x, sensor_data.accel_y, sensor_data.accel_z,
-                                 sensor_data.gyro_x, sensor_data.gyro_y, sensor_data.gyro_z,
-                                 sensor_data.temperature, timestamp_str);
+                                 stats_json, events_json, sensor_data.temperature, timestamp_str);
 
                         // Publica no broker
                         if (mqtt_connected && mqtt_client_is_connected(client))
@@ -266,7 +461,7 @@ int main()
                                 sleep_ms(50);
                                 gpio_put(LED_PIN_GREEN, 0);
                                 last_publish_time = get_absolute_time();
-                                last_published_data = sensor_data;
+                                last_published_stats = window_stats;
                             }
                             else
                             {
@@ -298,6 +493,8 @@ int main()
             }
         }
 
-        sleep_ms(50); // Pequena pausa para não ocupar 100% da CPU
+        display_message_step(); // Linhas de status longas rolam até o painel de dados assumir a tela
+
+        sleep_ms(50); // Pausa para não ocupar 100% da CPU (a FIFO é drenada pelo núcleo 1)
     }
 }
@@ -0,0 +1,341 @@
+#include "imu_fft.h"
+#include "imu_stats.h"
+#include "mailbox.h"
+#include <stdio.h>
+
+#define NORMALIZED_BITS 14 // O quadro é escalado para |x| < 2^14: a FFT não estoura
+
+// cos(2*pi*k/1024) em Q15 (1.0 = 32767), k = 0..512. Gerada uma vez, fica na flash:
+//   [max(-32767, min(32767, round(32767 * cos(2 * pi * k / 1024)))) for k in range(513)]
+// O seno sai da mesma tabela: sin(2*pi*k/1024) = cos(2*pi*(256 - k)/1024)
+static const int16_t cos_q15[IMU_FFT_MAX_POINTS / 2 + 1] = {
+    32767, 32766, 32765, 32761, 32757, 32752, 32745, 32737, 32728, 32717, 32705, 32692,
+    32678, 32663, 32646, 32628, 32609, 32589, 32567, 32545, 32521, 32495, 32469, 32441,
+    32412, 32382, 32351, 32318, 32285, 32250, 32213, 32176, 32137, 32098, 32057, 32014,
+    31971, 31926, 31880, 31833, 31785, 31736, 31685, 31633, 31580, 31526, 31470, 31414,
+    31356, 31297, 31237, 31176, 31113, 31050, 30985, 30919, 30852, 30783, 30714, 30643,
+    30571, 30498, 30424, 30349, 30273, 30195, 30117, 30037, 29956, 29874, 29791, 29706,
+    29621, 29534, 29447, 29358, 29268, 29177, 29085, 28992, 28898, 28803, 28706, 28609,
+    28510, 28411, 28310, 28208, 28105, 28001, 27896, 27790, 27683, 27575, 27466, 27356,
+    27245, 27133, 27019, 26905, 26790, 26674, 26556, 26438, 26319, 26198, 26077, 25955,
+    25832, 25708, 25582, 25456, 25329, 25201, 25072, 24942, 24811, 24680, 24547, 24413,
+    24279, 24143, 24007, 23870, 23731, 23592, 23452, 23311, 23170, 23027, 22884, 22739,
+    22594, 22448, 22301, 22154, 22005, 21856, 21705, 21554, 21403, 21250, 21096, 20942,
+    20787, 20631, 20475, 20317, 20159, 20000, 19841, 19680, 19519, 19357, 19195, 19032,
+    18868, 18703, 18537, 18371, 18204, 18037, 17869, 17700, 17530, 17360, 17189, 17018,
+    16846, 16673, 16499, 16325, 16151, 15976, 15800, 15623, 15446, 15269, 15090, 14912,
+    14732, 14553, 14372, 14191, 14010, 13828, 13645, 13462, 13279, 13094, 12910, 12725,
+    12539, 12353, 12167, 11980, 11793, 11605, 11417, 11228, 11039, 10849, 10659, 10469,
+    10278, 10087, 9896, 9704, 9512, 9319, 9126, 8933, 8739, 8545, 8351, 8157,
+    7962, 7767, 7571, 7375, 7179, 6983, 6786, 6590, 6393, 6195, 5998, 5800,
+    5602, 5404, 5205, 5007, 4808, 4609, 4410, 4210, 4011, 3811, 3612, 3412,
+    3212, 3012, 2811, 2611, 2410, 2210, 2009, 1809, 1608, 1407, 1206, 1005,
+    804, 603, 402, 201, 0, -201, -402, -603, -804, -1005, -1206, -1407,
+    -1608, -1809, -2009, -2210, -2410, -2611, -2811, -3012, -3212, -3412, -3612, -3811,
+    -4011, -4210, -4410, -4609, -4808, -5007, -5205, -5404, -5602, -5800, -5998, -6195,
+    -6393, -6590, -6786, -6983, -7179, -7375, -7571, -7767, -7962, -8157, -8351, -8545,
+    -8739, -8933, -9126, -9319, -9512, -9704, -9896, -10087, -10278, -10469, -10659, -10849,
+    -11039, -11228, -11417, -11605, -11793, -11980, -12167, -12353, -12539, -12725, -12910, -13094,
+    -13279, -13462, -13645, -13828, -14010, -14191, -14372, -14553, -14732, -14912, -15090, -15269,
+    -15446, -15623, -15800, -15976, -16151, -16325, -16499, -16673, -16846, -17018, -17189, -17360,
+    -17530, -17700, -17869, -18037, -18204, -18371, -18537, -18703, -18868, -19032, -19195, -19357,
+    -19519, -19680, -19841, -20000, -20159, -20317, -20475, -20631, -20787, -20942, -21096, -21250,
+    -21403, -21554, -21705, -21856, -22005, -22154, -22301, -22448, -22594, -22739, -22884, -23027,
+    -23170, -23311, -23452, -23592, -23731, -23870, -24007, -24143, -24279, -24413, -24547, -24680,
+    -24811, -24942, -25072, -25201, -25329, -25456, -25582, -25708, -25832, -25955, -26077, -26198,
+    -26319, -26438, -26556, -26674, -26790, -26905, -27019, -27133, -27245, -27356, -27466, -27575,
+    -27683, -27790, -27896, -28001, -28105, -28208, -28310, -28411, -28510, -28609, -28706, -28803,
+    -28898, -28992, -29085, -29177, -29268, -29358, -29447, -29534, -29621, -29706, -29791, -29874,
+    -29956, -30037, -30117, -30195, -30273, -30349, -30424, -30498, -30571, -30643, -30714, -30783,
+    -30852, -30919, -30985, -31050, -31113, -31176, -31237, -31297, -31356, -31414, -31470, -31526,
+    -31580, -31633, -31685, -31736, -31785, -31833, -31880, -31926, -31971, -32014, -32057, -32098,
+    -32137, -32176, -32213, -32250, -32285, -32318, -32351, -32382, -32412, -32441, -32469, -32495,
+    -32521, -32545, -32567, -32589, -32609, -32628, -32646, -32663, -32678, -32692, -32705, -32717,
+    -32728, -32737, -32745, -32752, -32757, -32761, -32765, -32766, -32767,
+};
+
+// Quadro em aquisição e área de trabalho da FFT: só o núcleo 1 usa
+static int16_t frame[3][IMU_FFT_MAX_POINTS];
+static int16_t work_re[IMU_FFT_MAX_POINTS], work_im[IMU_FFT_MAX_POINTS];
+static uint fill;
+
+// Configuração (escrita pelo núcleo 0 antes de o núcleo 1 começar)
+static uint fft_points;
+static uint16_t fft_rate_hz;
+static uint16_t band_edges[IMU_FFT_BANDS + 1];
+static uint band_bins[IMU_FFT_BANDS + 1]; // Primeira raia de cada faixa (e fim da última)
+
+// Saída para o núcleo 0: picos x, y, z e faixas x, y, z, na ordem de imu_fft_spectrum_t
+static mailbox_t spectrum_box[6];
+_Static_assert(sizeof(imu_fft_spectrum_t) == 3 * (sizeof(imu_fft_peaks_t) + sizeof(imu_fft_bands_t)),
+               "o grupo de caixas copia imu_fft_spectrum_t sem preenchimento entre os campos");
+
+// cos(2*pi*index/1024) para index = 0..1023
+static inline int32_t cos_full(uint index) {
+    return index <= IMU_FFT_MAX_POINTS / 2 ? cos_q15[index] : cos_q15[IMU_FFT_MAX_POINTS - index];
+}
+
+static inline bool valid_points(uint points) {
+    return points >= IMU_FFT_MIN_POINTS && points <= IMU_FFT_MAX_POINTS && (points & (points - 1)) == 0;
+}
+
+// Decimação no tempo: entrada em ordem de bits invertidos, borboletas com a escala 1/2 em cada
+// estágio. O laço externo é o do fator de giro, que é lido da tabela uma vez por grupo de borboletas
+bool imu_fft_q15(int16_t *re, int16_t *im, uint points) {
+    if (!valid_points(points)) {
+        return false;
+    }
+
+    for (uint i = 1, j = 0; i < points; i++) {
+        uint bit = points >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            int16_t swap = re[i];
+            re[i] = re[j];
+            re[j] = swap;
+            swap = im[i];
+            im[i] = im[j];
+            im[j] = swap;
+        }
+    }
+
+    for (uint length = 2; length <= points; length <<= 1) {
+        uint half = length >> 1;
+        uint step = IMU_FFT_MAX_POINTS / length;
+        for (uint k = 0; k < half; k++) {
+            // W = cos - j sin, com índice k * step < 512
+            int index = k * step;
+            int32_t wr = cos_q15[index];
+            int32_t wi = -cos_q15[index <= 256 ? 256 - index : index - 256];
+            for (uint i = k; i < points; i += length) {
+                uint j = i + half;
+                int32_t tr = (wr * re[j] - wi * im[j] + (1 << 14)) >> 15;
+                int32_t ti = (wr * im[j] + wi * re[j] + (1 << 14)) >> 15;
+                int32_t ar = re[i], ai = im[i];
+                re[i] = (ar + tr) >> 1;
+                im[i] = (ai + ti) >> 1;
+                re[j] = (ar - tr) >> 1;
+                im[j] = (ai - ti) >> 1;
+            }
+        }
+    }
+    return true;
+}
+
+bool imu_fft_init(uint points, uint16_t sample_rate_hz, const uint16_t band_edges_hz[IMU_FFT_BANDS + 1]) {
+    imu_fft_peaks_t no_peaks = {0};
+    imu_fft_bands_t no_bands = {0};
+    for (int axis = 0; axis < 3; axis++) {
+        mailbox_init(&spectrum_box[axis], sizeof(no_peaks), &no_peaks);
+        mailbox_init(&spectrum_box[3 + axis], sizeof(no_bands), &no_bands);
+    }
+
+    if (!valid_points(points) || sample_rate_hz == 0) {
+        fft_points = 0;
+        return false;
+    }
+    fft_points = points;
+    fft_rate_hz = sample_rate_hz;
+    fill = 0;
+
+    // Hz -> raia (resolução de sample_rate_hz / points), limitada às raias 1..points/2
+    for (int band = 0; band <= IMU_FFT_BANDS; band++) {
+        band_edges[band] = band_edges_hz[band];
+        uint bin = ((uint32_t)band_edges_hz[band] * points + sample_rate_hz / 2) / sample_rate_hz;
+        band_bins[band] = bin < 1 ? 1 : bin > points / 2 ? points / 2 : bin;
+    }
+    return true;
+}
+
+void imu_fft_add(const int16_t accel[3]) {
+    if (fill >= fft_points) {
+        return; // Quadro cheio (ou espectro desligado): espera imu_fft_process
+    }
+    for (int axis = 0; axis < 3; axis++) {
+        frame[axis][fill] = accel[axis];
+    }
+    fill++;
+}
+
+// Desfaz a normalização do quadro: valor * 2^-shift, arredondado
+static inline uint32_t denormalize(uint32_t value, int shift) {
+    return shift > 0 ? (value + (1u << (shift - 1))) >> shift : value << -shift;
+}
+
+static uint16_t to_mg(int axis, uint32_t raw) {
+    int32_t mg = imu_stats_scale(IMU_STATS_ACCEL_X + axis, raw);
+    return mg > UINT16_MAX ? UINT16_MAX : mg;
+}
+
+// Raiz de um valor de 64 bits: descarta pares de bits até caber em 32
+static uint32_t isqrt64(uint64_t value) {
+    int shift = 0;
+    while (value >> 32) {
+        value >>= 2;
+        shift++;
+    }
+    return imu_isqrt32((uint32_t)value) << shift;
+}
+
+static inline uint32_t power(uint bin) {
+    return (uint32_t)(work_re[bin] * work_re[bin]) + (uint32_t)(work_im[bin] * work_im[bin]);
+}
+
+static void analyze_axis(int axis, imu_fft_peaks_t *peaks, imu_fft_bands_t *bands) {
+    const int16_t *samples = frame[axis];
+    uint points = fft_points;
+
+    // Média (gravidade e offset) e maior desvio, para escalar o quadro para |x| < 2^14
+    int32_t sum = 0;
+    for (uint n = 0; n < points; n++) {
+        sum += samples[n];
+    }
+    int32_t mean = (sum >= 0 ? sum + (int32_t)points / 2 : sum - (int32_t)points / 2) / (int32_t)points;
+    int32_t peak = 0;
+    for (uint n = 0; n < points; n++) {
+        int32_t deviation = samples[n] - mean;
+        if (deviation < 0) deviation = -deviation;
+        if (deviation > peak) peak = deviation;
+    }
+    if (peak == 0) {
+        return; // Sinal constante: sem picos e sem energia
+    }
+    int shift = 0; // Positivo: o quadro foi multiplicado por 2^shift
+    if (peak < (1 << NORMALIZED_BITS)) {
+        while ((peak << (shift + 1)) < (1 << NORMALIZED_BITS)) {
+            shift++;
+        }
+    }
+    else {
+        while ((peak >> -shift) >= (1 << NORMALIZED_BITS)) {
+            shift--;
+        }
+    }
+
+    // Janela de Hann: w = (1 - cos(2*pi*n/N)) / 2, com o cosseno da mesma tabela
+    uint window_step = IMU_FFT_MAX_POINTS / points;
+    for (uint n = 0; n < points; n++) {
+        int32_t value = samples[n] - mean;
+        value = shift >= 0 ? value << shift : value >> -shift;
+        int32_t window = (32767 - cos_full(n * window_step)) >> 1;
+        work_re[n] = (value * window + (1 << 14)) >> 15;
+        work_im[n] = 0;
+    }
+    imu_fft_q15(work_re, work_im, points);
+
+    // Energia por faixa e os maiores máximos locais, direto na potência de cada raia
+    uint64_t band_energy[IMU_FFT_BANDS] = {0};
+    uint64_t total_energy = 0;
+    uint peak_bin[IMU_FFT_PEAKS] = {0};
+    uint32_t peak_power[IMU_FFT_PEAKS] = {0};
+    uint32_t previous = power(0), current = power(1);
+    uint band = 0;
+    for (uint k = 1; k < points / 2; k++) {
+        uint32_t next = power(k + 1);
+        total_energy += current;
+        while (band < IMU_FFT_BANDS && k >= band_bins[band + 1]) {
+            band++;
+        }
+        if (band < IMU_FFT_BANDS && k >= band_bins[band]) {
+            band_energy[band] += current;
+        }
+
+        if (current > previous && current >= next && current > peak_power[IMU_FFT_PEAKS - 1]) {
+            int slot = IMU_FFT_PEAKS - 1;
+            while (slot > 0 && current > peak_power[slot - 1]) {
+                peak_power[slot] = peak_power[slot - 1];
+                peak_bin[slot] = peak_bin[slot - 1];
+                slot--;
+            }
+            peak_power[slot] = current;
+            peak_bin[slot] = k;
+        }
+        previous = current;
+        current = next;
+    }
+
+    // Interpolação parabólica nas magnitudes em torno de cada pico: deslocamento da raia
+    // d = (c - a) / (2 * (2b - a - c)) e altura b - (a - c) * d / 4. Com a escala 1/N e a
+    // janela de Hann, uma senoide de amplitude A aparece com magnitude A/4
+    for (int i = 0; i < IMU_FFT_PEAKS; i++) {
+        uint k = peak_bin[i];
+        if (k == 0) {
+            break;
+        }
+        int32_t a = imu_isqrt32(power(k - 1));
+        int32_t b = imu_isqrt32(power(k));
+        int32_t c = imu_isqrt32(power(k + 1));
+        int32_t numerator = c - a;
+        int32_t denominator = 2 * (2 * b - a - c);
+        if (denominator <= 0) {
+            numerator = 0;
+            denominator = 1;
+        }
+        int64_t frequency = ((int64_t)k * denominator + numerator) * fft_rate_hz * 10;
+        int64_t scale = (int64_t)points * denominator;
+        peaks->frequency_dhz[i] = (frequency + scale / 2) / scale;
+        int32_t height = b - (int32_t)(((int64_t)(a - c) * numerator) / (4 * denominator));
+        peaks->amplitude_mg[i] = to_mg(axis, denormalize(4 * (uint32_t)height, shift));
+        if (peaks->amplitude_mg[i] == 0) {
+            peaks->frequency_dhz[i] = 0; // Só ruído de arredondamento
+        }
+    }
+
+    // Parseval com a janela de Hann (potência média 3/8) e espectro de um lado (x2):
+    // RMS^2 = 16/3 * soma das potências das raias
+    for (int i = 0; i < IMU_FFT_BANDS; i++) {
+        bands->band_mg[i] = to_mg(axis, denormalize(isqrt64(band_energy[i] * 16 / 3), shift));
+    }
+    bands->rms_mg = to_mg(axis, denormalize(isqrt64(total_energy * 16 / 3), shift));
+}
+
+bool imu_fft_process(void) {
+    if (fft_points == 0 || fill < fft_points) {
+        return false;
+    }
+
+    uint32_t start = time_us_32();
+    imu_fft_spectrum_t spectrum = {0};
+    for (int axis = 0; axis < 3; axis++) {
+        analyze_axis(axis, &spectrum.peaks[axis], &spectrum.bands[axis]);
+    }
+    uint32_t elapsed = time_us_32() - start;
+    for (int axis = 0; axis < 3; axis++) {
+        spectrum.bands[axis].transform_us = elapsed > UINT16_MAX ? UINT16_MAX : elapsed;
+    }
+
+    mailbox_write_group(spectrum_box, 6, &spectrum);
+    fill = 0;
+    return true;
+}
+
+uint32_t imu_fft_read(imu_fft_spectrum_t *spectrum) {
+    return mailbox_read_group(spectrum_box, 6, spectrum);
+}
+
+int imu_fft_format(char *buffer, size_t size, const imu_fft_spectrum_t *spectrum) {
+    static const char axis_names[3] = {'x', 'y', 'z'};
+
+    int used = snprintf(buffer, size, "{\"n\":%u,\"edges_hz\":[%u,%u,%u,%u,%u],\"us\":%u",
+                        fft_points, band_edges[0], band_edges[1], band_edges[2], band_edges[3],
+                        band_edges[4], spectrum->bands[0].transform_us);
+    for (int axis = 0; axis < 3 && used >= 0 && (size_t)used < size; axis++) {
+        const imu_fft_peaks_t *peaks = &spectrum->peaks[axis];
+        const imu_fft_bands_t *bands = &spectrum->bands[axis];
+        used += snprintf(buffer + used, size - used,
+                         ",\"%c\":{\"peaks\":[[%u,%u],[%u,%u],[%u,%u]],\"bands\":[%u,%u,%u,%u],\"rms\":%u}",
+                         axis_names[axis],
+                         peaks->frequency_dhz[0], peaks->amplitude_mg[0],
+                         peaks->frequency_dhz[1], peaks->amplitude_mg[1],
+                         peaks->frequency_dhz[2], peaks->amplitude_mg[2],
+                         bands->band_mg[0], bands->band_mg[1], bands->band_mg[2], bands->band_mg[3],
+                         bands->rms_mg);
+    }
+    if (used >= 0 && (size_t)used < size) {
+        used += snprintf(buffer + used, size - used, "}");
+    }
+    return used;
+}
@@ -0,0 +1,86 @@
+#ifndef IMU_FFT_H
+#define IMU_FFT_H
+
+#include <stddef.h>
+#include "pico/stdlib.h"
+
+// Espectro de vibração dos três eixos do acelerômetro: o núcleo 1 junta quadros de N amostras
+// (128 a 1024), remove a média, normaliza o quadro (ponto flutuante em bloco), aplica a janela de
+// Hann e calcula uma FFT radix-2 em ponto fixo Q15 com a tabela de cossenos na flash. De cada
+// espectro saem os picos mais altos (frequência interpolada) e a energia em faixas de frequência
+
+#define IMU_FFT_MIN_POINTS 128
+#define IMU_FFT_MAX_POINTS 1024
+#define IMU_FFT_PEAKS 3 // Picos publicados por eixo
+#define IMU_FFT_BANDS 4 // Faixas de energia por eixo
+
+// Limites das faixas em Hz (IMU_FFT_BANDS + 1 valores crescentes), para 1 kHz
+#define IMU_FFT_DEFAULT_BAND_EDGES {1, 10, 50, 150, 500}
+
+// Picos de um eixo, do mais alto para o mais baixo (amplitude 0: sem pico)
+typedef struct {
+    uint16_t frequency_dhz[IMU_FFT_PEAKS]; // Décimos de Hz
+    uint16_t amplitude_mg[IMU_FFT_PEAKS];  // Amplitude da senoide
+} imu_fft_peaks_t;
+
+// Energia de um eixo, como valor RMS em cada faixa
+typedef struct {
+    uint16_t band_mg[IMU_FFT_BANDS];
+    uint16_t rms_mg;       // RMS de todo o espectro, sem a média
+    uint16_t transform_us; // Tempo do último quadro (os três eixos) no núcleo 1
+} imu_fft_bands_t;
+
+// Espectro mais recente dos três eixos
+typedef struct {
+    imu_fft_peaks_t peaks[3];
+    imu_fft_bands_t bands[3];
+} imu_fft_spectrum_t;
+
+/**
+ * @brief FFT complexa no lugar, em Q15, com escala 1/N (um bit por estágio, sem estouro se
+ * as entradas tiverem módulo menor que 2^14).
+ * @param re Partes reais (entrada e saída).
+ * @param im Partes imaginárias (entrada e saída).
+ * @param points Número de pontos: potência de 2 entre IMU_FFT_MIN_POINTS e IMU_FFT_MAX_POINTS.
+ * @return false se points não for válido.
+ */
+bool imu_fft_q15(int16_t *re, int16_t *im, uint points);
+
+/**
+ * @brief Configura o tamanho dos quadros e as faixas. Chamada no núcleo 0, depois de
+ * mpu6050_init e antes de imu_fusion_start.
+ * @param points Pontos por quadro (potência de 2 entre 128 e 1024).
+ * @param sample_rate_hz Taxa das amostras.
+ * @param band_edges_hz Limites das faixas (ex.: IMU_FFT_DEFAULT_BAND_EDGES).
+ * @return false se points não for válido (o espectro fica desligado).
+ */
+bool imu_fft_init(uint points, uint16_t sample_rate_hz, const uint16_t band_edges_hz[IMU_FFT_BANDS + 1]);
+
+/**
+ * @brief Acrescenta uma amostra do acelerômetro ao quadro atual (núcleo 1).
+ * @param accel Aceleração crua (x, y, z).
+ */
+void imu_fft_add(const int16_t accel[3]);
+
+/**
+ * @brief Se o quadro está completo, calcula os espectros, publica o resultado e começa outro
+ * quadro (núcleo 1, entre lotes).
+ * @return true se um espectro novo foi publicado.
+ */
+bool imu_fft_process(void);
+
+/**
+ * @brief Copia o espectro mais recente.
+ * @param spectrum Ponteiro para a struct que recebe o espectro.
+ * @return Número de sequência (0: nenhum quadro completo ainda).
+ */
+uint32_t imu_fft_read(imu_fft_spectrum_t *spectrum);
+
+/**
+ * @brief Escreve o espectro em JSON compacto:
+ * {"n":N,"edges_hz":[..],"us":t,"x":{"peaks":[[dHz,mg],..],"bands":[..],"rms":mg},"y":{..},"z":{..}}.
+ * @return Tamanho escrito (como snprintf).
+ */
+int imu_fft_format(char *buffer, size_t size, const imu_fft_spectrum_t *spectrum);
+
+#endif // IMU_FFT_H
@@ -0,0 +1,277 @@
+#include "imu_fusion.h"
+#include "pico/multicore.h"
+#include "imu_stats.h"
+#include "imu_fft.h"
+#include "mailbox.h"
+#include <math.h>
+#include <stdio.h>
+
+// Ganhos do filtro de Mahony como deslocamentos, no passo de meio ângulo por amostra (a 1 kHz):
+// e * Kp * dt / 2 = e >> KP_SHIFT e Ki * dt * dt / 2 = 2^-KI_SHIFT
+#define KP_SHIFT 11          // Kp ≈ 1
+#define KP_SHIFT_CONVERGE 6  // Kp ≈ 31, logo após a calibração
+#define KI_SHIFT 24          // Ki ≈ 0,12
+
+#define STILL_LIMIT_RAW 400  // Variação máxima do giroscópio (LSB) aceita durante a calibração
+
+// Amostra crua e etapa, publicadas juntas (16 bytes, o tamanho de uma caixa de correio)
+typedef struct {
+    mpu6050_raw_t raw;
+    uint8_t status;
+    bool valid;
+} imu_fusion_sample_t;
+
+// Estado do filtro: só o núcleo 1 escreve
+static int32_t q[4] = {IMU_FUSION_Q30_ONE, 0, 0, 0};
+static int32_t integral[3];     // Termo integral, em meio ângulo por amostra (Q30)
+static int32_t bias_q4[3];      // Viés do giroscópio em LSB, com 4 bits de fração
+static mpu6050_scale_t half_angle_scale; // LSB (Q4) do giroscópio -> meio ângulo por amostra (Q30)
+static int32_t one_g_raw;       // 1 g na faixa configurada do acelerômetro
+static uint32_t phase_samples;  // Amostras restantes da etapa atual (calibração ou convergência)
+static int32_t calibration_sum[3], calibration_min[3], calibration_max[3];
+
+static imu_fusion_status_t status;
+static uint fusion_int_gpio;
+static uint16_t fusion_rate_hz;
+static dlpf_bandwidth_t fusion_dlpf;
+
+// Saídas para o núcleo 0 (um escritor: o núcleo 1). Legíveis mesmo sem imu_fusion_start (se o
+// MPU falhar): amostra inválida e etapa IMU_FUSION_STARTING
+static mailbox_t orientation_box = mailbox_initializer(sizeof(imu_orientation_t));
+static mailbox_t sample_box = mailbox_initializer(sizeof(imu_fusion_sample_t));
+
+static inline int32_t mul_q30(int32_t a, int32_t b) {
+    return (int32_t)(((int64_t)a * b) >> 30);
+}
+
+static void imu_fusion_begin_calibration(void) {
+    status = IMU_FUSION_CALIBRATING;
+    phase_samples = fusion_rate_hz; // 1 s parado
+    for (int axis = 0; axis < 3; axis++) {
+        calibration_sum[axis] = 0;
+        calibration_min[axis] = INT16_MAX;
+        calibration_max[axis] = INT16_MIN;
+    }
+}
+
+// Acumula o giroscópio parado; se a placa se mexer, a calibração recomeça
+static void imu_fusion_calibrate(const int16_t gyro[3]) {
+    for (int axis = 0; axis < 3; axis++) {
+        calibration_sum[axis] += gyro[axis];
+        if (gyro[axis] < calibration_min[axis]) calibration_min[axis] = gyro[axis];
+        if (gyro[axis] > calibration_max[axis]) calibration_max[axis] = gyro[axis];
+    }
+    if (--phase_samples > 0) {
+        return;
+    }
+
+    for (int axis = 0; axis < 3; axis++) {
+        if (calibration_max[axis] - calibration_min[axis] > STILL_LIMIT_RAW) {
+            imu_fusion_begin_calibration();
+            return;
+        }
+    }
+    int32_t count = fusion_rate_hz;
+    for (int axis = 0; axis < 3; axis++) {
+        int32_t sum_q4 = calibration_sum[axis] * 16;
+        bias_q4[axis] = (sum_q4 + (sum_q4 >= 0 ? count / 2 : -count / 2)) / count;
+        integral[axis] = 0;
+    }
+    status = IMU_FUSION_CONVERGING;
+    phase_samples = fusion_rate_hz; // 1 s com ganho alto
+}
+
+// Um passo do filtro de Mahony: o erro entre a gravidade medida e a estimada pelo quatérnio
+// corrige a velocidade angular, que é integrada no quatérnio. Tudo em inteiros (Q30)
+static void imu_fusion_update(const int16_t accel[3], const int16_t gyro[3]) {
+    int32_t h[3]; // Meio ângulo girado nesta amostra, em radianos Q30
+    for (int axis = 0; axis < 3; axis++) {
+        int64_t rate_q4 = (int32_t)gyro[axis] * 16 - bias_q4[axis];
+        h[axis] = (int32_t)((rate_q4 * half_angle_scale.multiplier) >> half_angle_scale.shift);
+    }
+
+    // Correção pela gravidade, só quando a aceleração medida está perto de 1 g (fora disso ela
+    // inclui movimento ou vibração e puxaria a orientação para o lado errado)
+    uint32_t norm = imu_isqrt32((uint32_t)(accel[0] * accel[0]) + (uint32_t)(accel[1] * accel[1]) +
+                                (uint32_t)(accel[2] * accel[2]));
+    int32_t deviation = (int32_t)norm - one_g_raw;
+    if (norm > 0 && deviation < one_g_raw / 4 && deviation > -one_g_raw / 4) {
+        int64_t inverse = ((int64_t)1 << 46) / norm;
+        int32_t a[3];
+        for (int axis = 0; axis < 3; axis++) {
+            a[axis] = (int32_t)((accel[axis] * inverse) >> 16);
+        }
+
+        // Gravidade estimada (terceira linha da matriz de rotação)
+        int32_t v[3] = {
+            2 * (mul_q30(q[1], q[3]) - mul_q30(q[0], q[2])),
+            2 * (mul_q30(q[0], q[1]) + mul_q30(q[2], q[3])),
+            mul_q30(q[0], q[0]) - mul_q30(q[1], q[1]) - mul_q30(q[2], q[2]) + mul_q30(q[3], q[3]),
+        };
+
+        // Erro = medida x estimada
+        int32_t e[3] = {
+            mul_q30(a[1], v[2]) - mul_q30(a[2], v[1]),
+            mul_q30(a[2], v[0]) - mul_q30(a[0], v[2]),
+            mul_q30(a[0], v[1]) - mul_q30(a[1], v[0]),
+        };
+
+        int kp_shift = status == IMU_FUSION_CONVERGING ? KP_SHIFT_CONVERGE : KP_SHIFT;
+        for (int axis = 0; axis < 3; axis++) {
+            if (status == IMU_FUSION_RUNNING) {
+                integral[axis] += e[axis] >> KI_SHIFT;
+            }
+            h[axis] += (e[axis] >> kp_shift) + integral[axis];
+        }
+    }
+
+    // q += q * (0, h)
+    int32_t q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+    q[0] = q0 - mul_q30(q1, h[0]) - mul_q30(q2, h[1]) - mul_q30(q3, h[2]);
+    q[1] = q1 + mul_q30(q0, h[0]) + mul_q30(q2, h[2]) - mul_q30(q3, h[1]);
+    q[2] = q2 + mul_q30(q0, h[1]) - mul_q30(q1, h[2]) + mul_q30(q3, h[0]);
+    q[3] = q3 + mul_q30(q0, h[2]) + mul_q30(q1, h[1]) - mul_q30(q2, h[0]);
+
+    // Renormaliza sem raiz: a norma fica perto de 1, então q *= (3 - |q|^2) / 2 basta
+    int64_t norm2 = (int64_t)mul_q30(q[0], q[0]) + mul_q30(q[1], q[1]) + mul_q30(q[2], q[2]) + mul_q30(q[3], q[3]);
+    int32_t factor = (int32_t)((((int64_t)3 << 30) - norm2) >> 1);
+    for (int i = 0; i < 4; i++) {
+        q[i] = mul_q30(q[i], factor);
+    }
+
+    if (status == IMU_FUSION_CONVERGING && --phase_samples == 0) {
+        status = IMU_FUSION_RUNNING;
+    }
+}
+
+// Escalas dependentes das faixas do MPU e da taxa (só na inicialização, então float aqui não pesa)
+static void imu_fusion_make_scales(void) {
+    mpu6050_scale_t accel_mg, gyro_mdps;
+    mpu6050_get_scales(&accel_mg, &gyro_mdps);
+    one_g_raw = ((int32_t)1000 << accel_mg.shift) / accel_mg.multiplier;
+
+    // Graus por LSB -> meio ângulo (rad) por amostra, em Q30, para o giroscópio em Q4
+    double deg_per_lsb = (double)gyro_mdps.multiplier / (1u << gyro_mdps.shift) / 1000.0;
+    double per_q4 = deg_per_lsb * (M_PI / 180.0) / (2.0 * fusion_rate_hz) * (1 << 30) / 16.0;
+    uint8_t shift = 0;
+    while (shift < 30 && per_q4 * (1u << (shift + 1)) < 32767.0) {
+        shift++;
+    }
+    half_angle_scale.multiplier = (uint16_t)lround(per_q4 * (1u << shift));
+    half_angle_scale.shift = shift;
+}
+
+static void imu_fusion_publish(const mpu6050_batch_t *batch) {
+    imu_orientation_t orientation = {{q[0], q[1], q[2], q[3]}};
+    mailbox_write(&orientation_box, &orientation);
+
+    imu_fusion_sample_t sample = {.status = status, .valid = batch->count > 0};
+    if (sample.valid) {
+        uint last = batch->count - 1;
+        for (int axis = 0; axis < 3; axis++) {
+            sample.raw.accel[axis] = batch->accel[axis][last];
+            sample.raw.gyro[axis] = batch->gyro[axis][last];
+        }
+        sample.raw.temperature = batch->temperature[last];
+    }
+    mailbox_write(&sample_box, &sample);
+}
+
+// Laço do núcleo 1: dorme até a FIFO atingir a marca, drena em rajada e filtra amostra a amostra
+// (cada amostra também alimenta as janelas de imu_stats e os quadros de imu_fft)
+static void imu_fusion_core1(void) {
+    static mpu6050_batch_t batch;
+
+    if (!mpu6050_fifo_init(fusion_int_gpio, fusion_rate_hz, fusion_dlpf)) {
+        status = IMU_FUSION_FAILED;
+        batch.count = 0;
+        imu_fusion_publish(&batch);
+        return;
+    }
+    imu_fusion_make_scales();
+    imu_fusion_begin_calibration();
+
+    while (true) {
+        mpu6050_fifo_wait(make_timeout_time_ms(100));
+        mpu6050_fifo_service();
+
+        while (mpu6050_fifo_pop_batch(&batch) > 0) {
+            for (uint i = 0; i < batch.count; i++) {
+                int16_t accel[3] = {batch.accel[0][i], batch.accel[1][i], batch.accel[2][i]};
+                int16_t gyro[3] = {batch.gyro[0][i], batch.gyro[1][i], batch.gyro[2][i]};
+                imu_stats_update(accel, gyro);
+                imu_fft_add(accel);
+                if (status == IMU_FUSION_CALIBRATING) {
+                    imu_fusion_calibrate(gyro);
+                }
+                else {
+                    imu_fusion_update(accel, gyro);
+                }
+            }
+            imu_fusion_publish(&batch);
+            imu_stats_publish();
+            imu_fft_process(); // Com o quadro completo leva alguns ms; a FIFO do MPU guarda ~70 ms
+        }
+    }
+}
+
+void imu_fusion_start(uint int_gpio, uint16_t sample_rate_hz, dlpf_bandwidth_t dlpf) {
+    fusion_int_gpio = int_gpio;
+    fusion_rate_hz = sample_rate_hz ? sample_rate_hz : 1000;
+    fusion_dlpf = dlpf;
+    status = IMU_FUSION_STARTING;
+
+    imu_orientation_t identity = {{IMU_FUSION_Q30_ONE, 0, 0, 0}};
+    imu_fusion_sample_t empty = {.status = IMU_FUSION_STARTING, .valid = false};
+    mailbox_init(&orientation_box, sizeof(identity), &identity);
+    mailbox_init(&sample_box, sizeof(empty), &empty);
+
+    multicore_launch_core1(imu_fusion_core1);
+}
+
+imu_fusion_status_t imu_fusion_status(void) {
+    imu_fusion_sample_t sample = {0};
+    mailbox_read(&sample_box, &sample);
+    return sample.status;
+}
+
+uint32_t imu_fusion_read(imu_orientation_t *orientation) {
+    return mailbox_read(&orientation_box, orientation);
+}
+
+bool imu_fusion_latest_sample(mpu6050_raw_t *raw) {
+    imu_fusion_sample_t sample = {0};
+    mailbox_read(&sample_box, &sample);
+    if (sample.valid) {
+        *raw = sample.raw;
+    }
+    return sample.valid;
+}
+
+void imu_fusion_euler_centi(const imu_orientation_t *orientation, int32_t rpy[3]) {
+    const float scale = 1.0f / IMU_FUSION_Q30_ONE;
+    float w = orientation->q[0] * scale, x = orientation->q[1] * scale;
+    float y = orientation->q[2] * scale, z = orientation->q[3] * scale;
+
+    float sin_pitch = 2.0f * (w * y - z * x);
+    if (sin_pitch > 1.0f) sin_pitch = 1.0f;
+    if (sin_pitch < -1.0f) sin_pitch = -1.0f;
+
+    const float to_centi = 18000.0f / (float)M_PI;
+    rpy[0] = lroundf(atan2f(2.0f * (w * x + y * z), 1.0f - 2.0f * (x * x + y * y)) * to_centi);
+    rpy[1] = lroundf(asinf(sin_pitch) * to_centi);
+    rpy[2] = lroundf(atan2f(2.0f * (w * z + x * y), 1.0f - 2.0f * (y * y + z * z)) * to_centi);
+}
+
+int imu_fusion_format(char *buffer, size_t size, const imu_orientation_t *orientation) {
+    int32_t rpy[3];
+    imu_fusion_euler_centi(orientation, rpy);
+
+    // Q30 -> Q14, arredondado
+    int q14[4];
+    for (int i = 0; i < 4; i++) {
+        q14[i] = (orientation->q[i] + (1 << 15)) >> 16;
+    }
+    return snprintf(buffer, size, "{\"q\":[%d,%d,%d,%d],\"rpy\":[%ld,%ld,%ld]}",
+                    q14[0], q14[1], q14[2], q14[3], (long)rpy[0], (long)rpy[1], (long)rpy[2]);
+}
@@ -0,0 +1,74 @@
+#ifndef IMU_FUSION_H
+#define IMU_FUSION_H
+
+#include <stddef.h>
+#include "pico/stdlib.h"
+#include "mpu6050_handler.h"
+
+// Fusão de sensores do MPU-6050 no segundo núcleo: o núcleo 1 assume o MPU (FIFO, pino INT e I2C),
+// calibra o viés do giroscópio com a placa parada e roda um filtro de Mahony em ponto fixo a cada
+// amostra. A orientação sai como quatérnio Q30 (w, x, y, z); sem magnetômetro, o yaw deriva devagar
+
+// Etapas da fusão, na ordem em que acontecem
+typedef enum {
+    IMU_FUSION_STARTING,    // Núcleo 1 ainda configurando o MPU
+    IMU_FUSION_CALIBRATING, // Medindo o viés do giroscópio (a placa deve ficar parada)
+    IMU_FUSION_CONVERGING,  // Ganho alto por alguns instantes para alinhar com a gravidade
+    IMU_FUSION_RUNNING,
+    IMU_FUSION_FAILED       // A FIFO do MPU não pôde ser configurada
+} imu_fusion_status_t;
+
+#define IMU_FUSION_Q30_ONE (1 << 30)
+
+// Orientação como quatérnio unitário em Q30: q[0] = w, q[1..3] = x, y, z
+typedef struct {
+    int32_t q[4];
+} imu_orientation_t;
+
+/**
+ * @brief Inicia a fusão no núcleo 1, que configura a FIFO do MPU-6050 e passa a drená-la.
+ * O MPU já deve ter sido iniciado por mpu6050_init; depois disso só o núcleo 1 usa o I2C dele.
+ * Se imu_stats_init e imu_fft_init foram chamadas antes, cada amostra também alimenta as
+ * estatísticas, os detectores e os quadros do espectro.
+ * @param int_gpio GPIO ligado ao pino INT do módulo.
+ * @param sample_rate_hz Amostras por segundo (os ganhos do filtro são ajustados para 1 kHz).
+ * @param dlpf Banda do filtro passa-baixas digital do MPU.
+ */
+void imu_fusion_start(uint int_gpio, uint16_t sample_rate_hz, dlpf_bandwidth_t dlpf);
+
+/**
+ * @brief Etapa atual da fusão.
+ * @return Um dos valores de imu_fusion_status_t.
+ */
+imu_fusion_status_t imu_fusion_status(void);
+
+/**
+ * @brief Copia a orientação mais recente (consistente, sem travar o núcleo 1).
+ * @param orientation Ponteiro para a struct que recebe o quatérnio.
+ * @return Número de sequência da orientação (muda a cada lote processado).
+ */
+uint32_t imu_fusion_read(imu_orientation_t *orientation);
+
+/**
+ * @brief Copia a amostra crua mais recente processada pelo núcleo 1.
+ * @param raw Ponteiro para a struct que recebe a amostra.
+ * @return true se já houve ao menos uma amostra.
+ */
+bool imu_fusion_latest_sample(mpu6050_raw_t *raw);
+
+/**
+ * @brief Converte o quatérnio em roll, pitch e yaw (centésimos de grau). Feito só na borda
+ * (exibição e publicação), com ponto flutuante.
+ * @param orientation Quatérnio Q30.
+ * @param rpy Recebe roll, pitch e yaw.
+ */
+void imu_fusion_euler_centi(const imu_orientation_t *orientation, int32_t rpy[3]);
+
+/**
+ * @brief Escreve o payload compacto da orientação: {"q":[w,x,y,z],"rpy":[r,p,y]},
+ * com o quatérnio em Q14 (inteiros de 16 bits) e os ângulos em centésimos de grau.
+ * @return Tamanho escrito (como snprintf).
+ */
+int imu_fusion_format(char *buffer, size_t size, const imu_orientation_t *orientation);
+
+#endif // IMU_FUSION_H
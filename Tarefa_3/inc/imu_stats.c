@@ -0,0 +1,331 @@
+#include "imu_stats.h"
+#include "mpu6050_handler.h"
+#include "mailbox.h"
+#include <math.h>
+#include <stdio.h>
+
+#define WINDOW_MASK (IMU_STATS_MAX_WINDOW - 1)
+#define TILT_HYSTERESIS_DEGREES 5 // A inclinação só termina abaixo de tilt_degrees - 5
+
+// Fila monotônica de números de amostra (módulo 2^16): a frente é sempre o extremo da janela
+typedef struct {
+    uint16_t sample[IMU_STATS_MAX_WINDOW];
+    uint16_t head;
+    uint16_t count;
+} monotonic_queue_t;
+
+// Janela de um canal
+typedef struct {
+    int16_t values[IMU_STATS_MAX_WINDOW]; // Buffer circular indexado pelo número da amostra
+    int32_t sum;
+    int64_t sum_squares;
+    int32_t tilt_sum;                     // Soma das últimas tilt_window_samples amostras
+    monotonic_queue_t min_queue, max_queue;
+} channel_window_t;
+
+// Estado das janelas e dos detectores: só o núcleo 1 escreve
+static channel_window_t windows[IMU_STATS_CHANNELS];
+static uint16_t sample_number; // Número da próxima amostra (módulo 2^16)
+static uint16_t filled;        // Amostras na janela, até window_samples
+static bool initialized;
+
+static uint16_t window_samples, tilt_window_samples;
+static int32_t one_g_raw, shock_raw, free_fall_raw;
+static uint16_t holdoff_samples, free_fall_samples, tilt_samples;
+static int32_t tilt_enter_cos_q15, tilt_leave_cos_q15; // Cosseno dos limites de inclinação
+
+static uint16_t holdoff_left, free_fall_run, tilt_run;
+static bool free_fall_reported;
+static bool reference_set;
+static int32_t reference[3];   // Gravidade de referência (média curta da primeira janela cheia)
+static uint32_t reference_norm;
+static imu_events_t events;
+
+static mpu6050_scale_t accel_scale, gyro_scale;
+
+// Saídas para o núcleo 0 (um escritor: o núcleo 1)
+static mailbox_t summary_box[IMU_STATS_CHANNELS];
+static mailbox_t events_box;
+
+uint32_t imu_isqrt32(uint32_t value) {
+    uint32_t root = 0;
+    uint32_t bit = 1u << 30;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+static inline uint16_t queue_front(const monotonic_queue_t *queue) {
+    return queue->sample[queue->head];
+}
+
+// Tira da frente a amostra que saiu da janela e insere a amostra n descartando, pelo fim, as que
+// nunca mais serão extremo (cada amostra entra e sai uma vez: O(1) amortizado). A frente sai antes
+// da inserção: numa sequência monotônica a fila chega a window_samples amostras, e com a janela
+// máxima a nova posição seria justamente a da frente
+static void queue_push(monotonic_queue_t *queue, const int16_t *values, uint16_t n, int16_t value, bool is_max) {
+    if (queue->count > 0 && (uint16_t)(n - queue->sample[queue->head]) >= window_samples) {
+        queue->head = (queue->head + 1) & WINDOW_MASK;
+        queue->count--;
+    }
+
+    while (queue->count > 0) {
+        uint16_t back = queue->sample[(queue->head + queue->count - 1) & WINDOW_MASK];
+        int16_t back_value = values[back & WINDOW_MASK];
+        if (is_max ? back_value > value : back_value < value) {
+            break;
+        }
+        queue->count--;
+    }
+    queue->sample[(queue->head + queue->count) & WINDOW_MASK] = n;
+    queue->count++;
+}
+
+static void window_update(channel_window_t *window, int16_t value) {
+    uint16_t n = sample_number;
+    if (filled >= window_samples) {
+        int32_t old = window->values[(uint16_t)(n - window_samples) & WINDOW_MASK];
+        window->sum -= old;
+        window->sum_squares -= old * old;
+    }
+    if (filled >= tilt_window_samples) {
+        window->tilt_sum -= window->values[(uint16_t)(n - tilt_window_samples) & WINDOW_MASK];
+    }
+
+    window->values[n & WINDOW_MASK] = value;
+    window->sum += value;
+    window->sum_squares += (int32_t)value * value;
+    window->tilt_sum += value;
+
+    queue_push(&window->min_queue, window->values, n, value, false);
+    queue_push(&window->max_queue, window->values, n, value, true);
+}
+
+// Inclinação: ângulo entre a média curta da gravidade e a referência, comparado pelo cosseno
+// (m . r < cos * |m| * |r|), sem trigonometria por amostra
+static void tilt_update(void) {
+    int32_t mean[3];
+    for (int axis = 0; axis < 3; axis++) {
+        mean[axis] = windows[IMU_STATS_ACCEL_X + axis].tilt_sum / tilt_window_samples;
+    }
+    uint32_t norm = imu_isqrt32((uint32_t)(mean[0] * mean[0]) + (uint32_t)(mean[1] * mean[1]) +
+                                (uint32_t)(mean[2] * mean[2]));
+
+    if (!reference_set) {
+        for (int axis = 0; axis < 3; axis++) {
+            reference[axis] = mean[axis];
+        }
+        reference_norm = norm;
+        reference_set = norm > 0;
+        return;
+    }
+
+    int64_t dot = (int64_t)mean[0] * reference[0] + (int64_t)mean[1] * reference[1] + (int64_t)mean[2] * reference[2];
+    int64_t norms = (int64_t)norm * reference_norm;
+    if (!events.tilted) {
+        if (dot * 32768 < tilt_enter_cos_q15 * norms) {
+            if (++tilt_run >= tilt_samples) {
+                events.tilted = true;
+                events.tilts++;
+                events.last = IMU_EVENT_TILT;
+                tilt_run = 0;
+            }
+        }
+        else {
+            tilt_run = 0;
+        }
+    }
+    else if (dot * 32768 > tilt_leave_cos_q15 * norms) {
+        events.tilted = false;
+    }
+}
+
+void imu_stats_init(const imu_stats_config_t *config, uint16_t sample_rate_hz) {
+    mpu6050_get_scales(&accel_scale, &gyro_scale);
+
+    window_samples = config->window_samples;
+    if (window_samples == 0 || window_samples > IMU_STATS_MAX_WINDOW) {
+        window_samples = IMU_STATS_MAX_WINDOW;
+    }
+    tilt_window_samples = config->tilt_window_samples;
+    if (tilt_window_samples == 0 || tilt_window_samples > window_samples) {
+        tilt_window_samples = window_samples;
+    }
+
+    // mg -> cru: cru = mg * 2^shift / multiplier
+    one_g_raw = ((int32_t)1000 << accel_scale.shift) / accel_scale.multiplier;
+    shock_raw = (int32_t)(((int64_t)config->shock_mg << accel_scale.shift) / accel_scale.multiplier);
+    free_fall_raw = (int32_t)(((int64_t)config->free_fall_mg << accel_scale.shift) / accel_scale.multiplier);
+
+    holdoff_samples = (uint32_t)config->holdoff_ms * sample_rate_hz / 1000;
+    free_fall_samples = (uint32_t)config->free_fall_ms * sample_rate_hz / 1000;
+    tilt_samples = (uint32_t)config->tilt_ms * sample_rate_hz / 1000;
+    if (free_fall_samples == 0) free_fall_samples = 1;
+    if (tilt_samples == 0) tilt_samples = 1;
+
+    // Cossenos só aqui (na inicialização o ponto flutuante não pesa)
+    uint16_t leave_degrees = config->tilt_degrees > TILT_HYSTERESIS_DEGREES ? config->tilt_degrees - TILT_HYSTERESIS_DEGREES : 0;
+    tilt_enter_cos_q15 = lroundf(cosf(config->tilt_degrees * (float)M_PI / 180.0f) * 32768.0f);
+    tilt_leave_cos_q15 = lroundf(cosf(leave_degrees * (float)M_PI / 180.0f) * 32768.0f);
+
+    imu_channel_stats_t empty = {0};
+    for (int channel = 0; channel < IMU_STATS_CHANNELS; channel++) {
+        mailbox_init(&summary_box[channel], sizeof(empty), &empty);
+    }
+    mailbox_init(&events_box, sizeof(events), &events);
+    initialized = true;
+}
+
+void imu_stats_update(const int16_t accel[3], const int16_t gyro[3]) {
+    if (!initialized) {
+        return;
+    }
+
+    uint32_t magnitude = imu_isqrt32((uint32_t)(accel[0] * accel[0]) + (uint32_t)(accel[1] * accel[1]) +
+                                     (uint32_t)(accel[2] * accel[2]));
+
+    for (int axis = 0; axis < 3; axis++) {
+        window_update(&windows[IMU_STATS_ACCEL_X + axis], accel[axis]);
+        window_update(&windows[IMU_STATS_GYRO_X + axis], gyro[axis]);
+    }
+    window_update(&windows[IMU_STATS_ACCEL_MAGNITUDE], magnitude > INT16_MAX ? INT16_MAX : (int16_t)magnitude);
+    sample_number++;
+    if (filled < window_samples) {
+        filled++;
+    }
+
+    // Choque: |a| acima de 1 g + shock_mg (o lado de baixo é da queda livre); o pico é acompanhado
+    // durante o intervalo de espera
+    if (holdoff_left > 0) {
+        holdoff_left--;
+        if (magnitude > events.shock_peak) {
+            events.shock_peak = magnitude > UINT16_MAX ? UINT16_MAX : magnitude;
+        }
+    }
+    else if ((int32_t)magnitude - one_g_raw > shock_raw) {
+        events.shocks++;
+        events.last = IMU_EVENT_SHOCK;
+        events.shock_peak = magnitude > UINT16_MAX ? UINT16_MAX : magnitude;
+        holdoff_left = holdoff_samples;
+    }
+
+    // Queda livre: |a| perto de 0 por free_fall_samples seguidas, contada uma vez por queda
+    if ((int32_t)magnitude < free_fall_raw) {
+        if (free_fall_run < free_fall_samples) {
+            free_fall_run++;
+        }
+        else if (!free_fall_reported) {
+            events.free_falls++;
+            events.last = IMU_EVENT_FREE_FALL;
+            free_fall_reported = true;
+        }
+    }
+    else {
+        free_fall_run = 0;
+        free_fall_reported = false;
+    }
+
+    if (filled >= tilt_window_samples) {
+        tilt_update();
+    }
+}
+
+void imu_stats_publish(void) {
+    if (!initialized) {
+        return;
+    }
+
+    // As divisões e raízes ficam aqui (uma vez por lote), não por amostra
+    imu_stats_summary_t summary = {0};
+    for (int channel = 0; channel < IMU_STATS_CHANNELS; channel++) {
+        const channel_window_t *window = &windows[channel];
+        imu_channel_stats_t stats = {0};
+        if (filled > 0) {
+            int64_t count = filled;
+            int64_t sum = window->sum;
+            int64_t variance = (window->sum_squares * count - sum * sum) / (count * count);
+            stats.mean = (sum >= 0 ? sum + count / 2 : sum - count / 2) / count;
+            stats.min = window->values[queue_front(&window->min_queue) & WINDOW_MASK];
+            stats.max = window->values[queue_front(&window->max_queue) & WINDOW_MASK];
+            stats.std = imu_isqrt32((uint32_t)variance);
+            stats.rms = imu_isqrt32((uint32_t)(window->sum_squares / count));
+            stats.count = filled;
+        }
+        summary.channel[channel] = stats;
+    }
+    mailbox_write_group(summary_box, IMU_STATS_CHANNELS, summary.channel);
+    mailbox_write(&events_box, &events);
+}
+
+// Os canais são escritos juntos a cada lote: todos vêm do mesmo instante
+void imu_stats_read(imu_stats_summary_t *summary) {
+    mailbox_read_group(summary_box, IMU_STATS_CHANNELS, summary->channel);
+}
+
+void imu_stats_read_events(imu_events_t *events_out) {
+    mailbox_read(&events_box, events_out);
+}
+
+int32_t imu_stats_scale(imu_stats_channel_t channel, int32_t raw) {
+    mpu6050_scale_t scale = channel >= IMU_STATS_GYRO_X && channel <= IMU_STATS_GYRO_Z ? gyro_scale : accel_scale;
+    int64_t round = scale.shift ? (int64_t)1 << (scale.shift - 1) : 0;
+    return (int32_t)(((int64_t)raw * scale.multiplier + round) >> scale.shift);
+}
+
+const char *imu_event_name(imu_event_t event) {
+    static const char *names[] = {"nenhum", "choque", "queda", "inclinacao"};
+    return event <= IMU_EVENT_TILT ? names[event] : "";
+}
+
+// Escreve o objeto de um sensor: "nome":{"mean":[x,y,z],"min":[..],"max":[..],"std":[..],"rms":[..]}
+static int format_sensor(char *buffer, size_t size, const char *name, const imu_stats_summary_t *summary,
+                         imu_stats_channel_t first) {
+    long value[5][3];
+    for (int axis = 0; axis < 3; axis++) {
+        imu_stats_channel_t channel = first + axis;
+        const imu_channel_stats_t *stats = &summary->channel[channel];
+        value[0][axis] = imu_stats_scale(channel, stats->mean);
+        value[1][axis] = imu_stats_scale(channel, stats->min);
+        value[2][axis] = imu_stats_scale(channel, stats->max);
+        value[3][axis] = imu_stats_scale(channel, stats->std);
+        value[4][axis] = imu_stats_scale(channel, stats->rms);
+    }
+    return snprintf(buffer, size,
+                    "\"%s\":{\"mean\":[%ld,%ld,%ld],\"min\":[%ld,%ld,%ld],\"max\":[%ld,%ld,%ld],"
+                    "\"std\":[%ld,%ld,%ld],\"rms\":[%ld,%ld,%ld]}",
+                    name, value[0][0], value[0][1], value[0][2], value[1][0], value[1][1], value[1][2],
+                    value[2][0], value[2][1], value[2][2], value[3][0], value[3][1], value[3][2],
+                    value[4][0], value[4][1], value[4][2]);
+}
+
+int imu_stats_format(char *buffer, size_t size, const imu_stats_summary_t *summary) {
+    char accel[192], gyro[192];
+    format_sensor(accel, sizeof(accel), "accel", summary, IMU_STATS_ACCEL_X);
+    format_sensor(gyro, sizeof(gyro), "gyro", summary, IMU_STATS_GYRO_X);
+
+    const imu_channel_stats_t *g = &summary->channel[IMU_STATS_ACCEL_MAGNITUDE];
+    return snprintf(buffer, size, "{%s,%s,\"g\":{\"mean\":%ld,\"min\":%ld,\"max\":%ld,\"std\":%ld}}",
+                    accel, gyro,
+                    (long)imu_stats_scale(IMU_STATS_ACCEL_MAGNITUDE, g->mean),
+                    (long)imu_stats_scale(IMU_STATS_ACCEL_MAGNITUDE, g->min),
+                    (long)imu_stats_scale(IMU_STATS_ACCEL_MAGNITUDE, g->max),
+                    (long)imu_stats_scale(IMU_STATS_ACCEL_MAGNITUDE, g->std));
+}
+
+int imu_stats_format_events(char *buffer, size_t size, const imu_events_t *events_in) {
+    return snprintf(buffer, size, "{\"shock\":%u,\"free_fall\":%u,\"tilt\":%u,\"tilted\":%s,\"last\":\"%s\",\"peak_mg\":%ld}",
+                    events_in->shocks, events_in->free_falls, events_in->tilts, events_in->tilted ? "true" : "false",
+                    imu_event_name(events_in->last),
+                    (long)imu_stats_scale(IMU_STATS_ACCEL_MAGNITUDE, events_in->shock_peak));
+}
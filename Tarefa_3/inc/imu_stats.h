@@ -0,0 +1,143 @@
+#ifndef IMU_STATS_H
+#define IMU_STATS_H
+
+#include <stddef.h>
+#include "pico/stdlib.h"
+
+// Estatísticas em janela deslizante e detecção de eventos sobre o fluxo do MPU-6050, atualizadas
+// a cada amostra em O(1) pelo núcleo 1: somas e somas de quadrados corridas (média, desvio e RMS)
+// e filas monotônicas (mínimo e máximo). Os detectores de choque, queda livre e inclinação usam
+// a magnitude da aceleração e a média curta do vetor gravidade. Tudo em valores crus (LSB);
+// a conversão para mg e mdps é feita só na leitura
+
+#define IMU_STATS_MAX_WINDOW 256 // Maior janela em amostras (potência de 2)
+
+// Canais acompanhados
+typedef enum {
+    IMU_STATS_ACCEL_X,
+    IMU_STATS_ACCEL_Y,
+    IMU_STATS_ACCEL_Z,
+    IMU_STATS_GYRO_X,
+    IMU_STATS_GYRO_Y,
+    IMU_STATS_GYRO_Z,
+    IMU_STATS_ACCEL_MAGNITUDE, // |a|, limitada a INT16_MAX
+    IMU_STATS_CHANNELS
+} imu_stats_channel_t;
+
+// Eventos detectados
+typedef enum {
+    IMU_EVENT_NONE,
+    IMU_EVENT_SHOCK,     // |a| bem acima de 1 g
+    IMU_EVENT_FREE_FALL, // |a| perto de 0 por um tempo mínimo
+    IMU_EVENT_TILT       // Gravidade afastada da posição de referência por um tempo mínimo
+} imu_event_t;
+
+// Configuração das janelas e dos detectores (unidades físicas; convertidas em imu_stats_init)
+typedef struct {
+    uint16_t window_samples;      // Janela das estatísticas (até IMU_STATS_MAX_WINDOW)
+    uint16_t tilt_window_samples; // Média curta da gravidade para a inclinação (até window_samples)
+    uint16_t shock_mg;            // |a| acima de 1 g + shock_mg conta como choque
+    uint16_t holdoff_ms;          // Tempo após um choque em que outro não é contado
+    uint16_t free_fall_mg;        // |a| abaixo disso conta como queda livre...
+    uint16_t free_fall_ms;        // ...se durar ao menos esse tempo
+    uint16_t tilt_degrees;        // Ângulo em relação à referência que conta como inclinação...
+    uint16_t tilt_ms;             // ...se durar ao menos esse tempo
+} imu_stats_config_t;
+
+// Valores padrão para 1 kHz
+#define IMU_STATS_DEFAULT_CONFIG { \
+    .window_samples = 256, .tilt_window_samples = 64, \
+    .shock_mg = 700, .holdoff_ms = 200, \
+    .free_fall_mg = 300, .free_fall_ms = 50, \
+    .tilt_degrees = 30, .tilt_ms = 500, \
+}
+
+// Estatísticas de um canal na janela, em valores crus
+typedef struct {
+    int16_t mean;
+    int16_t min;
+    int16_t max;
+    uint16_t std;   // Desvio padrão
+    uint16_t rms;
+    uint16_t count; // Amostras na janela (0: ainda sem dados)
+} imu_channel_stats_t;
+
+typedef struct {
+    imu_channel_stats_t channel[IMU_STATS_CHANNELS];
+} imu_stats_summary_t;
+
+// Contadores de eventos desde o início
+typedef struct {
+    uint16_t shocks;
+    uint16_t free_falls;
+    uint16_t tilts;
+    uint16_t shock_peak; // |a| crua mais alta do último choque
+    uint8_t last;        // Último evento (imu_event_t)
+    bool tilted;         // A placa está inclinada agora
+} imu_events_t;
+
+/**
+ * @brief Configura as janelas e os detectores. Chamada no núcleo 0, depois de mpu6050_init
+ * (usa as faixas configuradas) e antes de imu_fusion_start.
+ * @param config Configuração (ex.: IMU_STATS_DEFAULT_CONFIG).
+ * @param sample_rate_hz Taxa das amostras, para converter os tempos em amostras.
+ */
+void imu_stats_init(const imu_stats_config_t *config, uint16_t sample_rate_hz);
+
+/**
+ * @brief Acrescenta uma amostra às janelas e aos detectores (núcleo 1, O(1)).
+ * @param accel Aceleração crua (x, y, z).
+ * @param gyro Velocidade angular crua (x, y, z).
+ */
+void imu_stats_update(const int16_t accel[3], const int16_t gyro[3]);
+
+/**
+ * @brief Calcula as estatísticas atuais e as publica para o núcleo 0 (núcleo 1, uma vez por lote).
+ */
+void imu_stats_publish(void);
+
+/**
+ * @brief Copia as estatísticas mais recentes, todas do mesmo instante.
+ * @param summary Ponteiro para a struct que recebe as estatísticas.
+ */
+void imu_stats_read(imu_stats_summary_t *summary);
+
+/**
+ * @brief Copia os contadores de eventos mais recentes.
+ * @param events Ponteiro para a struct que recebe os contadores.
+ */
+void imu_stats_read_events(imu_events_t *events);
+
+/**
+ * @brief Converte um valor cru de um canal para mg (acelerômetro) ou mdps (giroscópio).
+ * @param channel Canal do valor.
+ * @param raw Valor cru (ou diferença de valores crus).
+ * @return Valor convertido.
+ */
+int32_t imu_stats_scale(imu_stats_channel_t channel, int32_t raw);
+
+/**
+ * @brief Nome curto do evento ("choque", "queda", "inclinacao").
+ */
+const char *imu_event_name(imu_event_t event);
+
+/**
+ * @brief Escreve as estatísticas em JSON compacto, em mg e mdps:
+ * {"accel":{"mean":[x,y,z],"min":[..],"max":[..],"std":[..],"rms":[..]},"gyro":{..},"g":{..}}.
+ * @return Tamanho escrito (como snprintf).
+ */
+int imu_stats_format(char *buffer, size_t size, const imu_stats_summary_t *summary);
+
+/**
+ * @brief Escreve os contadores de eventos em JSON compacto:
+ * {"shock":n,"free_fall":n,"tilt":n,"tilted":b,"last":"..","peak_mg":n}.
+ * @return Tamanho escrito (como snprintf).
+ */
+int imu_stats_format_events(char *buffer, size_t size, const imu_events_t *events);
+
+/**
+ * @brief Raiz quadrada inteira (parte inteira).
+ */
+uint32_t imu_isqrt32(uint32_t value);
+
+#endif // IMU_STATS_H
@@ -1,4 +1,6 @@
 #include "mpu6050_handler.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
 #include <stdio.h>
 
 // Endereços dos Registradores
@@ -7,11 +9,69 @@ static const uint8_t PWR_MGMT_1_REG     = 0x6B;
 static const uint8_t GYRO_CONFIG_REG    = 0x1B;
 static const uint8_t ACCEL_CONFIG_REG   = 0x1C;
 static const uint8_t ACCEL_XOUT_H_REG   = 0x3B;
+static const uint8_t SMPLRT_DIV_REG     = 0x19;
+static const uint8_t CONFIG_REG         = 0x1A;
+static const uint8_t FIFO_EN_REG        = 0x23;
+static const uint8_t INT_PIN_CFG_REG    = 0x37;
+static const uint8_t INT_ENABLE_REG     = 0x38;
+static const uint8_t INT_STATUS_REG     = 0x3A;
+static const uint8_t USER_CTRL_REG      = 0x6A;
+static const uint8_t FIFO_COUNTH_REG    = 0x72;
+static const uint8_t FIFO_R_W_REG       = 0x74;
+
+// Bits dos registradores do modo FIFO
+#define FIFO_EN_TEMP_XYZG_ACCEL 0xF8 // Temperatura, giroscópio X/Y/Z e acelerômetro: 14 bytes por amostra
+#define INT_PIN_CFG_RD_CLEAR    0x10 // Qualquer leitura limpa a interrupção (pulso de 50 us, ativo em nível alto)
+#define INT_ENABLE_DATA_RDY     0x01
+#define INT_STATUS_FIFO_OFLOW   0x10
+#define USER_CTRL_FIFO_EN       0x40
+#define USER_CTRL_FIFO_RESET    0x04
+
+#define MPU6050_SAMPLE_BYTES 14
+#define MPU6050_FIFO_BYTES 1024
 
 // Variáveis estáticas para guardar o estado da biblioteca
 static i2c_inst_t *i2c_port;
 static float accel_divisor;
 static float gyro_divisor;
+static float accel_reciprocal; // 1 / divisor: a conversão multiplica em vez de dividir (o M0+ não tem FPU)
+static float gyro_reciprocal;
+static mpu6050_scale_t accel_scale_mg;
+static mpu6050_scale_t gyro_scale_mdps;
+static const mpu6050_scale_t temperature_scale_centi = {19275, 16}; // 100 / 340 LSB por °C, em Q16
+#define TEMPERATURE_OFFSET_CENTI 3653                                // 36,53 °C
+
+// Estado do modo FIFO
+static uint fifo_int_gpio;
+static volatile uint32_t data_ready_count; // Pulsos do pino INT (escrito só pela interrupção)
+static uint32_t serviced_count;            // data_ready_count na última drenagem (escrito só pelo laço)
+static uint8_t fifo_burst[(MPU6050_FIFO_BYTES / MPU6050_SAMPLE_BYTES) * MPU6050_SAMPLE_BYTES];
+static mpu6050_raw_t ring[MPU6050_RING_SAMPLES];
+static uint32_t ring_head, ring_tail; // Contadores livres; a posição é o contador módulo o tamanho
+static mpu6050_fifo_stats_t fifo_stats;
+
+static void mpu6050_write_reg(uint8_t reg, uint8_t value) {
+    uint8_t buf[] = {reg, value};
+    i2c_write_blocking(i2c_port, MPU6050_ADDR, buf, 2, false);
+}
+
+static bool mpu6050_read_regs(uint8_t reg, uint8_t *dst, size_t len) {
+    if (i2c_write_blocking(i2c_port, MPU6050_ADDR, &reg, 1, true) != 1) {
+        return false;
+    }
+    return i2c_read_blocking(i2c_port, MPU6050_ADDR, dst, len, false) == (int)len;
+}
+
+// Amostra crua a partir de 14 bytes big-endian (registradores a partir de ACCEL_XOUT_H ou FIFO)
+static void mpu6050_parse(const uint8_t *buffer, mpu6050_raw_t *raw) {
+    raw->accel[0]    = (buffer[0] << 8) | buffer[1];
+    raw->accel[1]    = (buffer[2] << 8) | buffer[3];
+    raw->accel[2]    = (buffer[4] << 8) | buffer[5];
+    raw->temperature = (buffer[6] << 8) | buffer[7];
+    raw->gyro[0]     = (buffer[8] << 8) | buffer[9];
+    raw->gyro[1]     = (buffer[10] << 8) | buffer[11];
+    raw->gyro[2]     = (buffer[12] << 8) | buffer[13];
+}
 
 // Função interna para acordar o sensor
 static void mpu6050_wake_up() {
@@ -19,6 +79,20 @@ static void mpu6050_wake_up() {
     i2c_write_blocking(i2c_port, MPU6050_ADDR, buf, 2, false);
 }
 
+// Escala para numerator / denominator unidades por LSB, com o maior deslocamento que mantém o
+// multiplicador abaixo de 2^15 (só na inicialização, então 64 bits aqui não pesam)
+static mpu6050_scale_t mpu6050_make_scale(uint32_t numerator, uint32_t denominator) {
+    uint8_t shift = 0;
+    while (shift < 30 && (((uint64_t)numerator << (shift + 1)) + denominator / 2) / denominator < 32768) {
+        shift++;
+    }
+    mpu6050_scale_t scale = {
+        .multiplier = (((uint64_t)numerator << shift) + denominator / 2) / denominator,
+        .shift = shift,
+    };
+    return scale;
+}
+
 // --- Funções Públicas ---
 
 bool mpu6050_init(i2c_inst_t *i2c, gyro_fs_range_t gyro_range, accel_fs_range_t accel_range) {
@@ -50,6 +124,13 @@ bool mpu6050_init(i2c_inst_t *i2c, gyro_fs_range_t gyro_range, accel_fs_range_t
         case ACCEL_FS_8G:  accel_divisor = 4096.0f;  break;
         case ACCEL_FS_16G: accel_divisor = 2048.0f;  break;
     }
+    accel_reciprocal = 1.0f / accel_divisor;
+    gyro_reciprocal = 1.0f / gyro_divisor;
+
+    // Mesmas sensibilidades em inteiros: 16384 >> faixa LSB/g e (131, 65,5, 32,8, 16,4) LSB/(°/s)
+    static const uint16_t gyro_lsb_tenths[] = {1310, 655, 328, 164};
+    accel_scale_mg = mpu6050_make_scale(1000, 16384u >> accel_range);
+    gyro_scale_mdps = mpu6050_make_scale(10000, gyro_lsb_tenths[gyro_range]);
     
     // Testa se o dispositivo ainda está presente após a configuração
     uint8_t temp;
@@ -66,27 +147,172 @@ bool mpu6050_read_data(mpu6050_data_t *data) {
         return false;
     }
 
-    int16_t accel_raw[3], gyro_raw[3], temp_raw;
-
-    accel_raw[0] = (buffer[0] << 8) | buffer[1];
-    accel_raw[1] = (buffer[2] << 8) | buffer[3];
-    accel_raw[2] = (buffer[4] << 8) | buffer[5];
-    temp_raw     = (buffer[6] << 8) | buffer[7];
-    gyro_raw[0]  = (buffer[8] << 8) | buffer[9];
-    gyro_raw[1]  = (buffer[10] << 8) | buffer[11];
-    gyro_raw[2]  = (buffer[12] << 8) | buffer[13];
+    mpu6050_raw_t raw;
+    mpu6050_parse(buffer, &raw);
+    mpu6050_convert(&raw, data);
+    return true;
+}
 
-    // ATUALIZADO: Usa as variáveis de divisor em vez de números fixos
-    data->accel_x = accel_raw[0] / accel_divisor;
-    data->accel_y = accel_raw[1] / accel_divisor;
-    data->accel_z = accel_raw[2] / accel_divisor;
+void mpu6050_convert(const mpu6050_raw_t *raw, mpu6050_data_t *data) {
+    // Multiplica pelo inverso do divisor da faixa configurada (calculado uma vez em mpu6050_init)
+    data->accel_x = raw->accel[0] * accel_reciprocal;
+    data->accel_y = raw->accel[1] * accel_reciprocal;
+    data->accel_z = raw->accel[2] * accel_reciprocal;
     
-    data->gyro_x  = gyro_raw[0] / gyro_divisor;
-    data->gyro_y  = gyro_raw[1] / gyro_divisor;
-    data->gyro_z  = gyro_raw[2] / gyro_divisor;
+    data->gyro_x  = raw->gyro[0] * gyro_reciprocal;
+    data->gyro_y  = raw->gyro[1] * gyro_reciprocal;
+    data->gyro_z  = raw->gyro[2] * gyro_reciprocal;
     
-    // A fórmula da temperatura permanece a mesma
-    data->temperature = (temp_raw / 340.0f) + 36.53f;
+    // A fórmula da temperatura permanece a mesma: T = cru / 340 + 36,53
+    data->temperature = raw->temperature * (1.0f / 340.0f) + 36.53f;
+}
+
+void mpu6050_get_scales(mpu6050_scale_t *accel_mg, mpu6050_scale_t *gyro_mdps) {
+    *accel_mg = accel_scale_mg;
+    *gyro_mdps = gyro_scale_mdps;
+}
+
+void mpu6050_convert_batch(const int16_t *raw, int32_t *out, uint count, mpu6050_scale_t scale) {
+    int32_t multiplier = scale.multiplier;
+    int32_t round = scale.shift ? 1 << (scale.shift - 1) : 0;
+    for (uint i = 0; i < count; i++) {
+        out[i] = (raw[i] * multiplier + round) >> scale.shift;
+    }
+}
+
+int32_t mpu6050_temperature_centi(int16_t raw) {
+    int32_t centi;
+    mpu6050_convert_batch(&raw, &centi, 1, temperature_scale_centi);
+    return centi + TEMPERATURE_OFFSET_CENTI;
+}
+
+// --- Modo FIFO ---
+
+// Interrupção do pino INT: a cada amostra nova só incrementa o contador (custo fixo, sem I2C)
+static void mpu6050_int_handler(void) {
+    uint32_t events = gpio_get_irq_event_mask(fifo_int_gpio) & GPIO_IRQ_EDGE_RISE;
+    if (events) {
+        gpio_acknowledge_irq(fifo_int_gpio, events);
+        data_ready_count++;
+    }
+}
+
+// Descarta o conteúdo da FIFO e volta a enchê-la a partir de uma amostra inteira
+static void mpu6050_fifo_reset(void) {
+    mpu6050_write_reg(USER_CTRL_REG, USER_CTRL_FIFO_RESET);
+    mpu6050_write_reg(USER_CTRL_REG, USER_CTRL_FIFO_EN);
+}
+
+bool mpu6050_fifo_init(uint int_gpio, uint16_t sample_rate_hz, dlpf_bandwidth_t dlpf) {
+    // Taxa = taxa interna / (1 + SMPLRT_DIV); a interna é 8 kHz só com o filtro desligado
+    uint32_t internal_hz = dlpf == DLPF_260_HZ ? 8000 : 1000;
+    uint32_t divider = sample_rate_hz ? internal_hz / sample_rate_hz : 1;
+    if (divider < 1) divider = 1;
+    if (divider > 256) divider = 256;
 
+    mpu6050_write_reg(CONFIG_REG, dlpf);
+    mpu6050_write_reg(SMPLRT_DIV_REG, divider - 1);
+
+    // FIFO com amostras completas de 14 bytes, na mesma ordem dos registradores
+    mpu6050_write_reg(INT_ENABLE_REG, 0x00);
+    mpu6050_write_reg(USER_CTRL_REG, 0x00);
+    mpu6050_write_reg(FIFO_EN_REG, FIFO_EN_TEMP_XYZG_ACCEL);
+    mpu6050_fifo_reset();
+
+    // Pino INT: pulso a cada amostra pronta
+    fifo_int_gpio = int_gpio;
+    gpio_init(int_gpio);
+    gpio_set_dir(int_gpio, GPIO_IN);
+    gpio_pull_down(int_gpio);
+    gpio_add_raw_irq_handler(int_gpio, mpu6050_int_handler); // O driver do Wi-Fi também usa a interrupção do GPIO
+    gpio_set_irq_enabled(int_gpio, GPIO_IRQ_EDGE_RISE, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+
+    mpu6050_write_reg(INT_PIN_CFG_REG, INT_PIN_CFG_RD_CLEAR);
+    mpu6050_write_reg(INT_ENABLE_REG, INT_ENABLE_DATA_RDY);
+
+    // Confirma a configuração lendo o registrador de volta
+    uint8_t check;
+    return mpu6050_read_regs(FIFO_EN_REG, &check, 1) && check == FIFO_EN_TEMP_XYZG_ACCEL;
+}
+
+bool mpu6050_fifo_service(void) {
+    uint32_t count_snapshot = data_ready_count;
+    if (count_snapshot - serviced_count < MPU6050_FIFO_WATERMARK) {
+        return false;
+    }
+    serviced_count = count_snapshot;
+
+    // Estouro: a FIFO perdeu o alinhamento das amostras e precisa ser reiniciada
+    uint8_t status;
+    if (mpu6050_read_regs(INT_STATUS_REG, &status, 1) && (status & INT_STATUS_FIFO_OFLOW)) {
+        fifo_stats.overflows++;
+        mpu6050_fifo_reset();
+        return false;
+    }
+
+    uint8_t count_buf[2];
+    if (!mpu6050_read_regs(FIFO_COUNTH_REG, count_buf, 2)) {
+        return false;
+    }
+    uint32_t samples = (((uint32_t)count_buf[0] << 8) | count_buf[1]) / MPU6050_SAMPLE_BYTES;
+    if (samples == 0) {
+        return false;
+    }
+
+    // Uma única transação I2C para todas as amostras completas
+    if (!mpu6050_read_regs(FIFO_R_W_REG, fifo_burst, samples * MPU6050_SAMPLE_BYTES)) {
+        mpu6050_fifo_reset();
+        return false;
+    }
+    fifo_stats.bursts++;
+    fifo_stats.samples += samples;
+
+    for (uint32_t i = 0; i < samples; i++) {
+        if (ring_head - ring_tail >= MPU6050_RING_SAMPLES) {
+            fifo_stats.dropped += samples - i;
+            break;
+        }
+        mpu6050_parse(&fifo_burst[i * MPU6050_SAMPLE_BYTES], &ring[ring_head % MPU6050_RING_SAMPLES]);
+        ring_head++;
+    }
     return true;
-}
\ No newline at end of file
+}
+
+void mpu6050_fifo_wait(absolute_time_t until) {
+    // Cada pulso do INT acorda o WFE, mas só a marca de drenagem encerra a espera
+    while (data_ready_count - serviced_count < MPU6050_FIFO_WATERMARK) {
+        if (best_effort_wfe_or_timeout(until)) {
+            break;
+        }
+    }
+}
+
+uint mpu6050_fifo_pop(mpu6050_raw_t *samples, uint max) {
+    uint n = 0;
+    while (n < max && ring_tail != ring_head) {
+        samples[n++] = ring[ring_tail % MPU6050_RING_SAMPLES];
+        ring_tail++;
+    }
+    return n;
+}
+
+uint mpu6050_fifo_pop_batch(mpu6050_batch_t *batch) {
+    uint n = 0;
+    while (n < MPU6050_FIFO_WATERMARK && ring_tail != ring_head) {
+        const mpu6050_raw_t *raw = &ring[ring_tail % MPU6050_RING_SAMPLES];
+        for (int axis = 0; axis < 3; axis++) {
+            batch->accel[axis][n] = raw->accel[axis];
+            batch->gyro[axis][n] = raw->gyro[axis];
+        }
+        batch->temperature[n] = raw->temperature;
+        ring_tail++;
+        n++;
+    }
+    batch->count = n;
+    return n;
+}
+
+void mpu6050_fifo_get_stats(mpu6050_fifo_stats_t *stats) {
+    *stats = fifo_stats;
+}
@@ -1,6 +1,7 @@
 #ifndef MPU6050_HANDLER_H
 #define MPU6050_HANDLER_H
 
+#include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include <stdbool.h>
 
@@ -22,6 +23,55 @@ typedef enum {
     ACCEL_FS_16G  // ±16g
 } accel_fs_range_t;
 
+// Enum para o filtro passa-baixas digital (DLPF), banda do acelerômetro / giroscópio
+// Baseado no registrador CONFIG (0x1A). Com o filtro ligado, a taxa interna é 1 kHz; desligado, 8 kHz
+typedef enum {
+    DLPF_260_HZ, // 260 / 256 Hz (filtro desligado)
+    DLPF_184_HZ, // 184 / 188 Hz
+    DLPF_94_HZ,  // 94 / 98 Hz
+    DLPF_44_HZ,  // 44 / 42 Hz
+    DLPF_21_HZ,  // 21 / 20 Hz
+    DLPF_10_HZ,  // 10 / 10 Hz
+    DLPF_5_HZ    // 5 / 5 Hz
+} dlpf_bandwidth_t;
+
+// Amostras de 14 bytes (acelerômetro, temperatura, giroscópio) acumuladas na FIFO antes de drená-la.
+// A FIFO do MPU-6050 tem 1024 bytes (73 amostras): a 1 kHz a marca deixa ~40 ms de folga
+#define MPU6050_FIFO_WATERMARK 32
+
+// Amostras guardadas no buffer circular entre a drenagem da FIFO e o consumo (potência de 2)
+#define MPU6050_RING_SAMPLES 512
+
+// Amostra crua, na ordem dos registradores e da FIFO
+typedef struct {
+    int16_t accel[3];
+    int16_t temperature;
+    int16_t gyro[3];
+} mpu6050_raw_t;
+
+// Lote de amostras cruas em estrutura de vetores (um vetor int16 contíguo por eixo), para laços
+// de processamento sobre um eixo inteiro sem conversão para float
+typedef struct {
+    int16_t accel[3][MPU6050_FIFO_WATERMARK];
+    int16_t gyro[3][MPU6050_FIFO_WATERMARK];
+    int16_t temperature[MPU6050_FIFO_WATERMARK];
+    uint count; // Amostras válidas em cada vetor
+} mpu6050_batch_t;
+
+// Escala em ponto fixo: unidade = (cru * multiplier) >> shift. O multiplicador tem até 15 bits,
+// então o produto com um valor de 16 bits cabe numa multiplicação de 32 bits (sem 64 bits nem float)
+typedef struct {
+    uint16_t multiplier;
+    uint8_t shift;
+} mpu6050_scale_t;
+
+// Contadores do modo FIFO
+typedef struct {
+    uint32_t samples;   // Amostras lidas da FIFO
+    uint32_t bursts;    // Leituras em rajada
+    uint32_t overflows; // FIFO cheia: descartada e reiniciada
+    uint32_t dropped;   // Buffer circular cheio: amostras descartadas
+} mpu6050_fifo_stats_t;
 
 // Estrutura para guardar os dados lidos do sensor
 typedef struct {
@@ -46,4 +96,78 @@ bool mpu6050_init(i2c_inst_t *i2c, gyro_fs_range_t gyro_range, accel_fs_range_t
  */
 bool mpu6050_read_data(mpu6050_data_t *data);
 
+/**
+ * @brief Converte uma amostra crua para unidades físicas, com as faixas configuradas em mpu6050_init.
+ * @param raw Amostra crua (da FIFO ou dos registradores).
+ * @param data Ponteiro para a struct que recebe os dados convertidos.
+ */
+void mpu6050_convert(const mpu6050_raw_t *raw, mpu6050_data_t *data);
+
+/**
+ * @brief Escalas em ponto fixo das faixas configuradas em mpu6050_init.
+ * @param accel_mg Recebe a escala do acelerômetro para mg (milésimos de g).
+ * @param gyro_mdps Recebe a escala do giroscópio para mdps (milésimos de °/s).
+ */
+void mpu6050_get_scales(mpu6050_scale_t *accel_mg, mpu6050_scale_t *gyro_mdps);
+
+/**
+ * @brief Converte um vetor de valores crus de um eixo com uma escala em ponto fixo.
+ * @param raw Valores crus (ex.: batch.accel[0]).
+ * @param out Valores convertidos (pode ser usado um vetor por eixo, só quando necessário).
+ * @param count Quantidade de valores.
+ * @param scale Escala obtida de mpu6050_get_scales.
+ */
+void mpu6050_convert_batch(const int16_t *raw, int32_t *out, uint count, mpu6050_scale_t scale);
+
+/**
+ * @brief Converte a temperatura crua para centésimos de °C, sem ponto flutuante.
+ * @param raw Valor cru do sensor de temperatura.
+ * @return Temperatura em centésimos de grau.
+ */
+int32_t mpu6050_temperature_centi(int16_t raw);
+
+/**
+ * @brief Liga a aquisição contínua pela FIFO: taxa de amostragem, DLPF, FIFO e pino INT (data-ready).
+ * A interrupção do pino só conta amostras; a leitura em rajada é feita por mpu6050_fifo_service.
+ * @param int_gpio GPIO ligado ao pino INT do módulo.
+ * @param sample_rate_hz Amostras por segundo (até 1000 com o DLPF ligado).
+ * @param dlpf Banda do filtro passa-baixas digital.
+ * @return true se a configuração for bem-sucedida.
+ */
+bool mpu6050_fifo_init(uint int_gpio, uint16_t sample_rate_hz, dlpf_bandwidth_t dlpf);
+
+/**
+ * @brief Drena a FIFO para o buffer circular numa única leitura em rajada, se a interrupção já
+ * contou MPU6050_FIFO_WATERMARK amostras desde a última drenagem.
+ * @return true se amostras novas foram lidas.
+ */
+bool mpu6050_fifo_service(void);
+
+/**
+ * @brief Dorme (WFE) até a FIFO atingir a marca de drenagem ou até o prazo.
+ * @param until Prazo máximo de espera.
+ */
+void mpu6050_fifo_wait(absolute_time_t until);
+
+/**
+ * @brief Retira do buffer circular até max amostras, das mais antigas para as mais novas.
+ * @param samples Destino das amostras.
+ * @param max Capacidade de samples.
+ * @return Quantidade de amostras copiadas.
+ */
+uint mpu6050_fifo_pop(mpu6050_raw_t *samples, uint max);
+
+/**
+ * @brief Retira do buffer circular até MPU6050_FIFO_WATERMARK amostras para um lote em vetores.
+ * @param batch Lote que recebe as amostras (batch->count é atualizado).
+ * @return Quantidade de amostras copiadas.
+ */
+uint mpu6050_fifo_pop_batch(mpu6050_batch_t *batch);
+
+/**
+ * @brief Copia os contadores do modo FIFO.
+ * @param stats Ponteiro para a struct que recebe os contadores.
+ */
+void mpu6050_fifo_get_stats(mpu6050_fifo_stats_t *stats);
+
 #endif // MPU6050_HANDLER_H
\ No newline at end of file
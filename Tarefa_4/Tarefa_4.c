@@ -9,12 +9,15 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "semphr.h"
+#include "queue.h"
 
 // Hardware e Bibliotecas Locais
-#include "hardware/adc.h"
+#include "adc_sampler.h"
+#include "button.h"
+#include "temperature.h"
 #include "hardware/gpio.h"
 #include "hardware/i2c.h"
-#include "lib/ssd1306.h"
+#include "ssd1306_widget.h"
 
 #include "mqtt_psk_client.h"
 
@@ -27,6 +30,7 @@
 
 // --- Definições de Hardware ---
 #define TEMP_ADC_CHANNEL 4
+#define ADC_SAMPLE_RATE_HZ 1000 // Amostras por segundo do sensor de temperatura (lidas em médias)
 #define BUTTON_A_PIN 5
 #define BUTTON_B_PIN 6
 
@@ -36,12 +40,12 @@
 #define MQTT_PACKET_TYPE_SUBACK 0x90
 #define MQTT_PACKET_TYPE_PUBLISH 0x30
 
-uint8_t ssd[ssd1306_buffer_length];
-struct render_area frame_area = {
-    .start_column = 0,
-    .end_column = ssd1306_width - 1,
-    .start_page = 0,
-    .end_page = ssd1306_n_pages - 1};
+ssd1306_t display;
+SemaphoreHandle_t display_mutex; // Protege o framebuffer, desenhado por mais de uma tarefa
+ssd1306_widget_t status_lines[5]; // Linhas de display_message_init (letreiros se não couberem)
+bool status_hardware_scroll = false; // As linhas de status estão girando no controlador
+TaskHandle_t marquee_task_handle;  // Acordada quando alguma linha precisa rolar por software
+QueueHandle_t button_queue;        // Eventos dos botões, enviados pelas interrupções
 
 // --- Definições dos Tópicos MQTT ---
 #define TOPIC_SENSOR_TEMP "/aluno15/bitdoglab/temp"
@@ -53,7 +57,9 @@ struct render_area frame_area = {
 #define RX_TASK_PRIORITY (tskIDLE_PRIORITY + 2)
 #define BUTTON_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
 #define TEMP_PUBLISH_INTERVAL_MS 5000
-#define BUTTON_POLL_INTERVAL_MS 50
+#define BUTTON_QUEUE_LENGTH 16 // Eventos de botão aguardando a tarefa (os excedentes são descartados)
+#define MARQUEE_STEP_MS 60 // Intervalo entre passos (2 pixels) das linhas que rolam por software
+#define MARQUEE_HARDWARE_INTERVAL ssd1306_scroll_frames_3 // Rolagem pelo controlador (~33 px/s, como os passos)
 
 // --- Credenciais PSK (Pré-Shared Key) ---
 const unsigned char psk_identity[] = "aluno15";
@@ -71,39 +77,78 @@ typedef struct
 int build_mqtt_connect(const char *client_id, const char *username, unsigned char *buf, int buf_len);
 int build_mqtt_publish(const char *topic, const char *payload, unsigned char *buf, int buf_len);
 int build_mqtt_subscribe(const char *topic, unsigned char *buf, int buf_len);
-float read_onboard_temperature();
 
  // --- Implementações das Funções ---
-// Lê a temperatura do sensor interno do RP2040
-float read_onboard_temperature()
-{
-    const float conversion_factor = 3.3f / (1 << 12);
-    adc_select_input(4);
-    uint16_t raw = adc_read();
-    float voltage = raw * conversion_factor;
-    return 27.0f - (voltage - 0.706f) / 0.001721f;
-}
-// Inicializa o display OLED e exibe mensagens
+// Inicializa o display OLED e exibe mensagens. Linhas mais largas que a tela viram letreiros em
+// vez de cortadas: se todas cabem na GDDRAM o próprio controlador as gira (comandos 0x26/0x27),
+// sem tráfego I2C; senão display_marquee_task as desloca
 void display_message_init(const char *line1, const char *line2, const char *line3, const char *line4, const char *line5)
 {
-    // Cria área de renderização que cobre toda a tela
-    struct render_area area = {0, ssd1306_width - 1, 0, ssd1306_n_pages - 1};
-    calculate_render_area_buffer_length(&area);
-    uint8_t buffer[ssd1306_buffer_length];
-    memset(buffer, 0, sizeof(buffer)); // Limpa o buffer antes de desenhar
+    static const int line_x[5] = {5, 5, 0, 0, 0};
+    static const int line_y[5] = {0, 16, 32, 48, 56};
+    const char *lines[5] = {line1, line2, line3, line4, line5};
+    bool scrolling = false;
+
+    xSemaphoreTake(display_mutex, portMAX_DELAY);
+    ssd1306_clear(&display); // Limpa o buffer antes de desenhar
 
     // Escreve cada linha no display (se não for NULL)
-    if (line1)
-        ssd1306_draw_string(buffer, 5, 0, (char *)line1);
-    if (line2)
-        ssd1306_draw_string(buffer, 5, 16, (char *)line2);
-    if (line3)
-        ssd1306_draw_string(buffer, 0, 32, (char *)line3);
-    if (line4)
-        ssd1306_draw_string(buffer, 0, 48, (char *)line4);
-    if (line5)
-        ssd1306_draw_string(buffer, 0, 56, (char *)line5);
-    render_on_display(buffer, &area); // Atualiza display com conteúdo do buffer
+    for (int i = 0; i < 5; i++)
+    {
+        ssd1306_marquee_init(&status_lines[i], line_x[i], line_y[i], ssd1306_width - line_x[i]);
+        if (lines[i])
+        {
+            ssd1306_marquee_set(&display, &status_lines[i], lines[i]);
+            scrolling |= ssd1306_marquee_scrolling(&status_lines[i]);
+        }
+    }
+
+    // Atualiza display com conteúdo do buffer (encerrar a rolagem anterior já reenvia a tela)
+    if (status_hardware_scroll)
+        ssd1306_stop_scroll(&display);
+    else
+        ssd1306_send_data(&display);
+    status_hardware_scroll = scrolling && ssd1306_marquee_hardware_lines(&display, status_lines, 5, MARQUEE_HARDWARE_INTERVAL);
+    xSemaphoreGive(display_mutex);
+
+    if (scrolling && !status_hardware_scroll)
+        xTaskNotifyGive(marquee_task_handle);
+}
+
+// Tarefa que desloca as linhas de status mais largas que a tela que não puderam ir para o
+// hardware (texto maior que a GDDRAM). Cada passo redesenha só a faixa das linhas que rolam e
+// envia apenas essas páginas
+static void display_marquee_task(void *pvParameters)
+{
+    while (true)
+    {
+        // Dorme até display_message_init exibir uma linha que não cabe
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        bool scrolling = true;
+        while (scrolling)
+        {
+            vTaskDelay(pdMS_TO_TICKS(MARQUEE_STEP_MS));
+
+            xSemaphoreTake(display_mutex, portMAX_DELAY);
+            scrolling = false;
+            for (int i = 0; i < 5; i++)
+                scrolling |= ssd1306_marquee_step(&display, &status_lines[i], 2);
+            render_dirty_on_display(&display);
+            xSemaphoreGive(display_mutex);
+        }
+    }
+}
+
+// Tarefa de provisionamento pela serial: atende os comandos "cal" e "cal <graus>"
+// (temperature_calibration_poll) sem ocupar a CPU enquanto nada chega
+static void calibration_task(void *pvParameters)
+{
+    while (true)
+    {
+        temperature_calibration_poll();
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
 }
 
 // Tarefa para receber mensagens MQTT
@@ -143,16 +188,26 @@ static void mqtt_receive_task(void *pvParameters)
     }
 }
 
-// Função para tratar o evento de pressionar um botão
-void handle_button_press(char button_name, task_shared_params_t *params)
+// Chamada nas interrupções do GPIO e do alarme a cada evento de botão: só enfileira, e a tarefa
+// dos botões acorda na hora
+static void button_event_isr(const button_event_t *event, void *user_data)
+{
+    BaseType_t woken = pdFALSE;
+    xQueueSendFromISR(button_queue, event, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+// Função para publicar um evento de botão
+void handle_button_event(char button_name, const button_event_t *event, task_shared_params_t *params)
 {
     char payload_buf[128];
     unsigned char btn_mqtt_buf[256];
 
-    // Monta o payload JSON e a mensagem do display dinamicamente
-    snprintf(payload_buf, sizeof(payload_buf), "{\"botao\": \"%c\", \"estado\": \"pressionado\"}", button_name);
+    // Monta o payload JSON com o estado e o instante do evento (microssegundos desde o boot)
+    snprintf(payload_buf, sizeof(payload_buf), "{\"botao\": \"%c\", \"estado\": \"%s\", \"t_us\": %llu}",
+             button_name, button_event_name(event->type), (unsigned long long)event->time_us);
 
-    printf("[BTN_TASK] Botao %c pressionado. Publicando: %s\n", button_name, payload_buf);
+    printf("[BTN_TASK] Botao %c %s. Publicando: %s\n", button_name, button_event_name(event->type), payload_buf);
 
     // Envia a mensagem MQTT
     if (xSemaphoreTake(params->mqtt_mutex, portMAX_DELAY) == pdTRUE)
@@ -162,45 +217,36 @@ void handle_button_press(char button_name, task_shared_params_t *params)
         xSemaphoreGive(params->mqtt_mutex);
     }
 }
+
+// Tarefa que publica os eventos dos botões; dorme na fila até a próxima interrupção
 static void button_monitor_task(void *pvParameters)
 {
     task_shared_params_t *params = (task_shared_params_t *)pvParameters;
-    unsigned char btn_mqtt_buf[256];
-    char payload_buf[128];
-
-    // Variáveis de estado para debounce (detecção de borda)
-    static bool btn_a_last_state = true; // true = solto
-    static bool btn_b_last_state = true;
+    button_event_t event;
 
     while (true)
     {
-        bool btn_a_current_state = gpio_get(BUTTON_A_PIN);
-        bool btn_b_current_state = gpio_get(BUTTON_B_PIN);
+        xQueueReceive(button_queue, &event, portMAX_DELAY);
 
-        // Verifica mudança de estado do Botão A (de solto para pressionado)
-        if (btn_a_current_state == false && btn_a_last_state == true)
-        {
-            char display_str[16]; // Nome mais claro
-            float temp = read_onboard_temperature();
-            snprintf(display_str, sizeof(display_str), " %.2f°C", temp);
-            handle_button_press('A', params);
-            display_message_init("Temperatura:", display_str, "Bot.A Precionado", "Bot. B solto.", NULL);
-        }
+        char button_name = event.gpio == BUTTON_A_PIN ? 'A' : 'B';
+        handle_button_event(button_name, &event, params);
 
-        // Verifica mudança de estado do Botão B (de solto para pressionado)
-        if (btn_b_current_state == false && btn_b_last_state == true)
+        if (event.type == button_press)
         {
             char display_str[16]; // Nome mais claro
-            float temp = read_onboard_temperature();
-            snprintf(display_str, sizeof(display_str), "%.2f°C", temp);
-            handle_button_press('B', params);
-            display_message_init("Temperatura:", display_str, "Bot. A solto", "Bot.B Precionado.", NULL);
+            char temp[12]; // Temperatura em texto, com duas casas decimais
+            temperature_format(temp, sizeof(temp), temperature_read_centi());
+            if (button_name == 'A')
+            {
+                snprintf(display_str, sizeof(display_str), " %s°C", temp);
+                display_message_init("Temperatura:", display_str, "Bot.A Precionado", "Bot. B solto.", NULL);
+            }
+            else
+            {
+                snprintf(display_str, sizeof(display_str), "%s°C", temp);
+                display_message_init("Temperatura:", display_str, "Bot. A solto", "Bot.B Precionado.", NULL);
+            }
         }
-
-        btn_a_last_state = btn_a_current_state;
-        btn_b_last_state = btn_b_current_state;
-
-        vTaskDelay(pdMS_TO_TICKS(BUTTON_POLL_INTERVAL_MS));
     }
 }
 
@@ -220,6 +266,11 @@ static void connection_manager_task(void *pvParameters)
     {
         printf(" Falha crítica na conexão Wi-Fi. Reiniciando.\n");
         display_message_init("Falha na", "conexão Wi-Fi", "Reiniciando em", "5s", NULL);
+        // O laço de espera abaixo não deixa a tarefa dos letreiros rodar: a rolagem fica com o hardware
+        xSemaphoreTake(display_mutex, portMAX_DELAY);
+        for (int i = 0; i < 5 && !status_hardware_scroll; i++)
+            status_hardware_scroll = ssd1306_marquee_hardware(&display, &status_lines[i], ssd1306_scroll_frames_5);
+        xSemaphoreGive(display_mutex);
         vTaskDelay(pdMS_TO_TICKS(5000));
         while (1)
             ;
@@ -285,16 +336,17 @@ static void connection_manager_task(void *pvParameters)
         {
             char payload_buf[128];
             char display_str[16]; // Nome mais claro
-            float temp = read_onboard_temperature();
+            char temp[12]; // Temperatura em texto, com duas casas decimais
+            temperature_format(temp, sizeof(temp), temperature_read_centi());
 
-            snprintf(display_str, sizeof(display_str), "  %.2f°C", temp);
+            snprintf(display_str, sizeof(display_str), "  %s°C", temp);
             display_message_init("Temperatura:", display_str, "Bot. A Solto", "Bot. B Solto", NULL);
 
-            snprintf(payload_buf, sizeof(payload_buf), "{\"Temperatura\": %.2f}", temp);
+            snprintf(payload_buf, sizeof(payload_buf), "{\"Temperatura\": %s}", temp);
 
             if (xSemaphoreTake(params.mqtt_mutex, portMAX_DELAY) == pdTRUE)
             {
-                printf("Publicando temperatura: %.2f C\n", temp);
+                printf("Publicando temperatura: %s C\n", temp);
                 int len = build_mqtt_publish(TOPIC_SENSOR_TEMP, payload_buf, local_mqtt_buf, sizeof(local_mqtt_buf));
                 if (mqtt_psk_client_send(&client_ctx, local_mqtt_buf, len) < 0)
                 {
@@ -329,20 +381,20 @@ int main()
     gpio_set_function(I2C1_SCL, GPIO_FUNC_I2C);
     gpio_pull_up(I2C1_SDA);
     gpio_pull_up(I2C1_SCL);
-    ssd1306_init(i2c1);
-
-    adc_init();
-    adc_set_temp_sensor_enabled(true);
-    adc_select_input(TEMP_ADC_CHANNEL);
-    gpio_init(BUTTON_A_PIN);
-    gpio_set_dir(BUTTON_A_PIN, GPIO_IN);
-    gpio_pull_up(BUTTON_A_PIN);
-    gpio_init(BUTTON_B_PIN);
-    gpio_set_dir(BUTTON_B_PIN, GPIO_IN);
-    gpio_pull_up(BUTTON_B_PIN);
+    ssd1306_init(&display, ssd1306_width, ssd1306_height, false, ssd1306_i2c_address, i2c1);
+    display_mutex = xSemaphoreCreateMutex();
+
+    adc_sampler_init(1u << TEMP_ADC_CHANNEL, ADC_SAMPLE_RATE_HZ);
+    temperature_init(temperature_filter_shift_default);
+
+    // Botões ligados ao terra: eventos com debounce chegam por button_queue
+    button_queue = xQueueCreate(BUTTON_QUEUE_LENGTH, sizeof(button_event_t));
+    button_init((1u << BUTTON_A_PIN) | (1u << BUTTON_B_PIN), true, button_event_isr, NULL);
 
     printf("\n--- Monitor de Sensores MQTT v2.0 ---\n");
 
+    xTaskCreate(display_marquee_task, "MarqueeTask", 512, NULL, BUTTON_TASK_PRIORITY, &marquee_task_handle);
+    xTaskCreate(calibration_task, "CalibrationTask", 512, NULL, BUTTON_TASK_PRIORITY, NULL); // Página da flash e printf na pilha
     xTaskCreate(connection_manager_task, "MainTask", 4096, NULL, MAIN_TASK_PRIORITY, NULL);
     vTaskStartScheduler();
     // O código nunca deve chegar aqui
@@ -0,0 +1,178 @@
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "button.h"
+
+#define button_edges (GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE)
+
+typedef struct {
+    uint8_t gpio;
+    bool pressed;          // Estado já filtrado
+    bool long_sent;        // O pressionamento atual já gerou button_long_press
+    bool double_sent;      // O pressionamento atual já gerou button_double_click
+    uint64_t edge_us;      // Primeira borda da rajada que está assentando
+    uint64_t press_us;     // Início do pressionamento atual
+    uint64_t click_us;     // Início do último pressionamento curto (0: nenhum candidato a duplo)
+    alarm_id_t long_alarm; // Alarme do pressionamento longo (0: nenhum)
+} button_t;
+
+// A interrupção do GPIO e a do alarme têm a mesma prioridade e não se interrompem, então o estado
+// de cada botão só é alterado por uma delas de cada vez
+static button_t buttons[button_max];
+static uint button_count;
+static bool active_low;
+static button_callback_t event_callback;
+static void *event_user_data;
+
+static bool button_level(const button_t *button) {
+    return gpio_get(button->gpio) != active_low;
+}
+
+static void button_emit(const button_t *button, button_event_type_t type, uint64_t time_us) {
+    button_event_t event = {.time_us = time_us, .gpio = button->gpio, .type = type};
+    if (event_callback) {
+        event_callback(&event, event_user_data);
+    }
+}
+
+static int64_t button_long_alarm(alarm_id_t id, void *user_data) {
+    button_t *button = user_data;
+    button->long_alarm = 0;
+    if (button->pressed) {
+        button->long_sent = true;
+        button_emit(button, button_long_press, time_us_64());
+    }
+    return 0;
+}
+
+// O nível assentado mudou: gera os eventos e agenda ou cancela o prazo do pressionamento longo
+static void button_changed(button_t *button) {
+    button->pressed = !button->pressed;
+    if (button->pressed) {
+        button->press_us = button->edge_us;
+        button->long_sent = false;
+        button_emit(button, button_press, button->edge_us);
+
+        button->double_sent = button->click_us && button->press_us - button->click_us <= button_double_click_us;
+        if (button->double_sent) {
+            button_emit(button, button_double_click, button->edge_us);
+        }
+
+        int id = add_alarm_in_us(button_long_press_us, button_long_alarm, button, true);
+        button->long_alarm = id > 0 ? id : 0;
+    }
+    else {
+        if (button->long_alarm) {
+            cancel_alarm(button->long_alarm);
+            button->long_alarm = 0;
+        }
+        // Só um clique curto, que não fechou um duplo, pode ser a primeira metade do próximo
+        button->click_us = button->long_sent || button->double_sent ? 0 : button->press_us;
+        button_emit(button, button_release, button->edge_us);
+    }
+}
+
+// Fim do debounce: compara o nível com o estado anterior e volta a ouvir as bordas do pino
+static int64_t button_settled(alarm_id_t id, void *user_data) {
+    button_t *button = user_data;
+    if (button_level(button) != button->pressed) {
+        button_changed(button);
+    }
+    gpio_set_irq_enabled(button->gpio, button_edges, true);
+
+    // Uma borda entre a leitura e a reativação não gera interrupção: confere o nível de novo e,
+    // se mudou, repete o debounce a partir de agora
+    if (button_level(button) != button->pressed) {
+        gpio_set_irq_enabled(button->gpio, button_edges, false);
+        button->edge_us = time_us_64();
+        return button_debounce_us;
+    }
+    return 0;
+}
+
+static void button_irq_handler(void) {
+    for (uint i = 0; i < button_count; i++) {
+        button_t *button = &buttons[i];
+        uint32_t events = gpio_get_irq_event_mask(button->gpio) & button_edges;
+        if (!events) {
+            continue;
+        }
+        gpio_acknowledge_irq(button->gpio, events);
+
+        // Primeira borda: os repiques seguintes são ignorados até o alarme
+        button->edge_us = time_us_64();
+        gpio_set_irq_enabled(button->gpio, button_edges, false);
+        if (add_alarm_in_us(button_debounce_us, button_settled, button, true) >= 0) {
+            continue;
+        }
+
+        // Sem alarmes livres: decide com o nível atual. Se ele mudou de novo, button_settled
+        // desliga a interrupção e pede outro debounce; sem alarme para isso, aceita o novo nível
+        // e volta a ouvir o pino, em vez de deixar o botão surdo
+        int64_t retry_us = button_settled(0, button);
+        if (retry_us > 0 && add_alarm_in_us(retry_us, button_settled, button, true) < 0) {
+            button_changed(button);
+            gpio_set_irq_enabled(button->gpio, button_edges, true);
+        }
+    }
+}
+
+// Configura os botões dos GPIO em gpio_mask (até button_max), com pull-up se active_low (botão
+// ligado ao terra) ou pull-down. callback recebe os eventos na interrupção
+void button_init(uint32_t gpio_mask, bool low, button_callback_t callback, void *user_data) {
+    active_low = low;
+    event_callback = callback;
+    event_user_data = user_data;
+
+    uint32_t mask = 0;
+    for (uint gpio = 0; gpio < 32 && button_count < button_max; gpio++) {
+        if (!(gpio_mask & (1u << gpio))) {
+            continue;
+        }
+        gpio_init(gpio);
+        gpio_set_dir(gpio, GPIO_IN);
+        if (active_low) {
+            gpio_pull_up(gpio);
+        }
+        else {
+            gpio_pull_down(gpio);
+        }
+
+        button_t *button = &buttons[button_count++];
+        button->gpio = gpio;
+        button->pressed = button_level(button);
+        mask |= 1u << gpio;
+    }
+
+    // Manipulador próprio (raw) em vez do callback único do GPIO, que o driver do Wi-Fi também usa
+    gpio_add_raw_irq_handler_masked(mask, button_irq_handler);
+    for (uint i = 0; i < button_count; i++) {
+        gpio_set_irq_enabled(buttons[i].gpio, button_edges, true);
+    }
+    irq_set_enabled(IO_IRQ_BANK0, true);
+}
+
+// Estado filtrado do botão no GPIO dado (false se não é um botão configurado)
+bool button_pressed(uint gpio) {
+    for (uint i = 0; i < button_count; i++) {
+        if (buttons[i].gpio == gpio) {
+            return buttons[i].pressed;
+        }
+    }
+    return false;
+}
+
+// Nome do evento nas mensagens publicadas
+const char *button_event_name(button_event_type_t type) {
+    switch (type) {
+    case button_press:
+        return "pressionado";
+    case button_release:
+        return "solto";
+    case button_long_press:
+        return "longo";
+    case button_double_click:
+        return "duplo";
+    default:
+        return "";
+    }
+}
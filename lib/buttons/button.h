@@ -0,0 +1,42 @@
+#ifndef button_h
+#define button_h
+
+#include "pico/stdlib.h"
+
+// Botões lidos por interrupção de borda do GPIO. A primeira borda desliga a interrupção do pino
+// e agenda um alarme; quando ele dispara o nível já assentou e é comparado com o estado anterior,
+// então os repiques não geram eventos. Os eventos levam o instante (time_us_64) da primeira borda
+
+#define button_max 4 // Botões atendidos
+
+#ifndef button_debounce_us
+#define button_debounce_us 10000 // Tempo para o contato assentar depois da primeira borda
+#endif
+#ifndef button_long_press_us
+#define button_long_press_us 800000 // Pressionamento mais longo que isso gera button_long_press
+#endif
+#ifndef button_double_click_us
+#define button_double_click_us 400000 // Dois pressionamentos curtos dentro disso geram button_double_click
+#endif
+
+typedef enum {
+    button_press,
+    button_release,
+    button_long_press,  // Ainda pressionado depois de button_long_press_us
+    button_double_click // Segundo pressionamento (enviado logo após o seu button_press)
+} button_event_type_t;
+
+typedef struct {
+    uint64_t time_us; // Instante da borda que iniciou o evento (ou do fim do prazo, no long_press)
+    uint8_t gpio;
+    uint8_t type;     // button_event_type_t
+} button_event_t;
+
+// Chamada na interrupção do GPIO ou do alarme a cada evento (use apenas funções ...FromISR)
+typedef void (*button_callback_t)(const button_event_t *event, void *user_data);
+
+extern void button_init(uint32_t gpio_mask, bool active_low, button_callback_t callback, void *user_data);
+extern bool button_pressed(uint gpio);
+extern const char *button_event_name(button_event_type_t type);
+
+#endif
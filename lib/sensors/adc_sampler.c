@@ -0,0 +1,166 @@
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "adc_sampler.h"
+
+// Dois blocos de amostras intercaladas na ordem do round-robin (canal a, canal b, ..., canal a, ...)
+static uint16_t samples[2][adc_sampler_inputs * adc_sampler_block];
+
+// Endereços lidos pelo canal de controle, que rearma o canal de dados alternando os blocos.
+// A leitura dá a volta a cada 8 bytes (anel do DMA), por isso o alinhamento
+static uint16_t *block_address[2] __attribute__((aligned(8))) = {samples[0], samples[1]};
+
+static uint8_t inputs[adc_sampler_inputs]; // Entradas amostradas, em ordem crescente (ordem do round-robin)
+static uint input_count;
+
+static int data_channel = -1;
+static int control_channel;
+static uint done_block; // Bloco que o canal de dados completa na próxima interrupção
+
+static volatile uint16_t average[adc_sampler_inputs];
+static volatile uint16_t oversampled[adc_sampler_inputs];
+static volatile uint16_t latest[adc_sampler_inputs];
+static volatile uint32_t blocks;
+
+static adc_sampler_callback_t block_callback[adc_sampler_max_callbacks];
+static void *block_user_data[adc_sampler_max_callbacks];
+static uint callback_count;
+
+// Fim de um bloco: o canal de controle já apontou o DMA para o outro buffer, então este pode ser
+// lido à vontade até o próximo bloco terminar
+static void adc_sampler_irq_handler() {
+    if (!dma_channel_get_irq0_status(data_channel)) {
+        return;
+    }
+    dma_channel_acknowledge_irq0(data_channel);
+
+    const uint16_t *block = samples[done_block];
+    done_block ^= 1;
+
+    for (uint i = 0; i < input_count; i++) {
+        uint32_t sum = 0;
+        for (uint k = 0; k < adc_sampler_block; k++) {
+            sum += block[k * input_count + i];
+        }
+        average[inputs[i]] = (sum + adc_sampler_block / 2) / adc_sampler_block;
+        oversampled[inputs[i]] = (sum * 16 + adc_sampler_block / 2) / adc_sampler_block;
+        latest[inputs[i]] = block[(adc_sampler_block - 1) * input_count + i];
+    }
+    blocks++;
+
+    for (uint i = 0; i < callback_count; i++) {
+        block_callback[i](block_user_data[i]);
+    }
+}
+
+// Inicia a aquisição contínua das entradas em input_mask (bit n = entrada n), cada uma
+// amostrada sample_rate_hz vezes por segundo. Assume o ADC inteiro: configura os GPIO e o
+// sensor de temperatura, e ninguém mais deve chamar adc_select_input/adc_read depois disso
+void adc_sampler_init(uint32_t input_mask, uint32_t sample_rate_hz) {
+    if (data_channel >= 0) {
+        return;
+    }
+
+    input_mask &= (1u << adc_sampler_inputs) - 1;
+    if (input_mask == 0 || sample_rate_hz == 0) {
+        return;
+    }
+
+    adc_init();
+    input_count = 0;
+    for (uint input = 0; input < adc_sampler_inputs; input++) {
+        if (!(input_mask & (1u << input))) {
+            continue;
+        }
+
+        if (input == adc_sampler_temperature_input) {
+            adc_set_temp_sensor_enabled(true);
+        }
+        else {
+            adc_gpio_init(26 + input);
+        }
+
+        // Primeira leitura avulsa: os valores já são válidos antes do primeiro bloco
+        adc_select_input(input);
+        average[input] = latest[input] = adc_read();
+        oversampled[input] = average[input] << 4;
+
+        inputs[input_count++] = input;
+    }
+
+    // Round-robin a partir da menor entrada: a ordem se repete igual em todos os blocos
+    adc_select_input(inputs[0]);
+    adc_set_round_robin(input_mask);
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_fifo_drain();
+
+    // Uma conversão a cada (1 + div) ciclos do clock do ADC, repartidas entre as entradas
+    float div = (float)clock_get_hz(clk_adc) / ((float)sample_rate_hz * input_count) - 1.0f;
+    adc_set_clkdiv(div > 0.0f ? div : 0.0f);
+
+    data_channel = dma_claim_unused_channel(true);
+    control_channel = dma_claim_unused_channel(true);
+
+    // Dados: FIFO do ADC -> bloco atual; ao terminar, encadeia o canal de controle
+    dma_channel_config config = dma_channel_get_default_config(data_channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+    channel_config_set_read_increment(&config, false);
+    channel_config_set_write_increment(&config, true);
+    channel_config_set_dreq(&config, DREQ_ADC);
+    channel_config_set_chain_to(&config, control_channel);
+    dma_channel_configure(data_channel, &config, samples[0], &adc_hw->fifo, input_count * adc_sampler_block, false);
+
+    // Controle: escreve o endereço do próximo bloco no registrador de escrita do canal de
+    // dados (o alias que dispara a transferência), alternando entre as duas entradas da tabela
+    config = dma_channel_get_default_config(control_channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_ring(&config, false, 3);
+    dma_channel_configure(control_channel, &config, &dma_hw->ch[data_channel].al2_write_addr_trig,
+                          &block_address[1], 1, false);
+
+    done_block = 0;
+    dma_channel_set_irq0_enabled(data_channel, true);
+    irq_add_shared_handler(DMA_IRQ_0, adc_sampler_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+
+    dma_channel_start(data_channel);
+    adc_run(true);
+}
+
+// Acrescenta uma função chamada (na interrupção do DMA) a cada bloco de médias novo.
+// Retorna false se já há adc_sampler_max_callbacks registradas
+bool adc_sampler_add_callback(adc_sampler_callback_t callback, void *user_data) {
+    uint32_t status = save_and_disable_interrupts();
+    bool added = callback_count < adc_sampler_max_callbacks;
+    if (added) {
+        block_callback[callback_count] = callback;
+        block_user_data[callback_count] = user_data;
+        callback_count++;
+    }
+    restore_interrupts(status);
+    return added;
+}
+
+// Média (12 bits) do último bloco completo da entrada; 0 se a entrada não é amostrada
+uint16_t adc_sampler_average(uint input) {
+    return input < adc_sampler_inputs ? average[input] : 0;
+}
+
+// Média do último bloco com 4 bits a mais de resolução (0 a 65520): a soma das amostras
+// sobreamostradas preserva a fração que o arredondamento para 12 bits descartaria
+uint16_t adc_sampler_oversampled(uint input) {
+    return input < adc_sampler_inputs ? oversampled[input] : 0;
+}
+
+// Amostra mais recente (12 bits) da entrada entregue pelo último bloco
+uint16_t adc_sampler_latest(uint input) {
+    return input < adc_sampler_inputs ? latest[input] : 0;
+}
+
+// Blocos completos desde o início; permite saber se há médias novas desde a última leitura
+uint32_t adc_sampler_blocks(void) {
+    return blocks;
+}
@@ -0,0 +1,30 @@
+#ifndef adc_sampler_h
+#define adc_sampler_h
+
+#include "pico/stdlib.h"
+
+// Serviço de aquisição do ADC: o conversor roda sozinho em round-robin pelos canais pedidos e o
+// DMA grava as amostras em blocos, alternando entre dois buffers sem intervenção da CPU. A cada
+// bloco completo a interrupção do DMA calcula a média de cada canal; as tarefas só leem esses
+// valores (adc_sampler_average / adc_sampler_latest), sem tocar no multiplexador do ADC
+
+#define adc_sampler_inputs 5 // Entradas do ADC: 0-3 nos GPIO 26-29, 4 no sensor de temperatura
+#define adc_sampler_temperature_input 4
+
+#ifndef adc_sampler_block
+#define adc_sampler_block 16 // Amostras de cada canal por bloco (média e decimação)
+#endif
+
+#define adc_sampler_max_callbacks 4 // Funções chamadas a cada bloco (adc_sampler_add_callback)
+
+// Chamada na interrupção do DMA depois que as médias de um bloco foram atualizadas
+typedef void (*adc_sampler_callback_t)(void *user_data);
+
+extern void adc_sampler_init(uint32_t input_mask, uint32_t sample_rate_hz);
+extern bool adc_sampler_add_callback(adc_sampler_callback_t callback, void *user_data);
+extern uint16_t adc_sampler_average(uint input);
+extern uint16_t adc_sampler_oversampled(uint input);
+extern uint16_t adc_sampler_latest(uint input);
+extern uint32_t adc_sampler_blocks(void);
+
+#endif
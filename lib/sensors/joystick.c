@@ -0,0 +1,91 @@
+#include "adc_sampler.h"
+#include "joystick.h"
+
+// Estado de um eixo: -1 (mínimo), 0 (neutro) ou 1 (máximo), com o centro medido no início
+typedef struct {
+    uint input;
+    int32_t center;
+    int8_t state;
+} joystick_axis_t;
+
+static joystick_axis_t axis_x, axis_y;
+static int32_t release_distance; // Zona morta: abaixo disso o eixo volta ao neutro
+static int32_t press_distance;   // Zona morta + histerese: acima disso o eixo sai do neutro
+static volatile joystick_direction_t direction = joystick_center;
+static joystick_callback_t event_callback;
+static void *event_user_data;
+
+// Direção para cada combinação de estados dos eixos: [y + 1][x + 1] (y positivo = cima)
+static const joystick_direction_t directions[3][3] = {
+    {joystick_down_left, joystick_down, joystick_down_right},
+    {joystick_left, joystick_center, joystick_right},
+    {joystick_up_left, joystick_up, joystick_up_right},
+};
+
+static const char *const direction_names[joystick_directions] = {
+    [joystick_center] = "Centro",
+    [joystick_up] = "Cima",
+    [joystick_up_right] = "Cima-Dir",
+    [joystick_right] = "Direita",
+    [joystick_down_right] = "Baixo-Dir",
+    [joystick_down] = "Baixo",
+    [joystick_down_left] = "Baixo-Esq",
+    [joystick_left] = "Esquerda",
+    [joystick_up_left] = "Cima-Esq",
+};
+
+// Comparador com histerese: o eixo só muda de lado depois de cruzar press_distance, e só
+// volta ao neutro abaixo de release_distance, então o ruído perto de um limiar não gera eventos
+static void joystick_update_axis(joystick_axis_t *axis) {
+    int32_t offset = (int32_t)adc_sampler_average(axis->input) - axis->center;
+    int32_t magnitude = offset < 0 ? -offset : offset;
+    int8_t side = offset < 0 ? -1 : 1;
+
+    if (axis->state != 0 && (magnitude < release_distance || side != axis->state)) {
+        axis->state = 0;
+    }
+    if (axis->state == 0 && magnitude > press_distance) {
+        axis->state = side;
+    }
+}
+
+// Chamada pelo adc_sampler a cada bloco de médias
+static void joystick_block(void *user_data) {
+    (void)user_data;
+    joystick_update_axis(&axis_x);
+    joystick_update_axis(&axis_y);
+
+    joystick_direction_t current = directions[axis_y.state + 1][axis_x.state + 1];
+    if (current != direction) {
+        direction = current;
+        if (event_callback) {
+            event_callback(current, event_user_data);
+        }
+    }
+}
+
+// Passa a acompanhar o joystick nas entradas x_input e y_input do ADC (já amostradas pelo
+// adc_sampler). A posição atual é tomada como centro, então o joystick deve estar solto
+void joystick_init(uint x_input, uint y_input, uint16_t deadzone, uint16_t hysteresis,
+                   joystick_callback_t callback, void *user_data) {
+    axis_x.input = x_input;
+    axis_x.center = adc_sampler_average(x_input);
+    axis_y.input = y_input;
+    axis_y.center = adc_sampler_average(y_input);
+    release_distance = deadzone;
+    press_distance = deadzone + hysteresis;
+    event_callback = callback;
+    event_user_data = user_data;
+
+    adc_sampler_add_callback(joystick_block, NULL);
+}
+
+// Direção atual (a do último evento)
+joystick_direction_t joystick_direction(void) {
+    return direction;
+}
+
+// Nome exibido para a direção (ex.: "Cima", "Baixo-Esq", "Centro")
+const char *joystick_direction_name(joystick_direction_t direction) {
+    return direction < joystick_directions ? direction_names[direction] : "";
+}
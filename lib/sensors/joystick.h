@@ -0,0 +1,34 @@
+#ifndef joystick_h
+#define joystick_h
+
+#include "pico/stdlib.h"
+
+// Joystick analógico lido pelo adc_sampler: a cada bloco de médias (na interrupção do DMA) os
+// dois eixos são comparados com limiares em torno do centro, com zona morta e histerese, e só
+// uma mudança de direção gera um evento. Quem consome os eventos pode dormir até lá
+
+#define joystick_deadzone_default 900   // Distância do centro (12 bits) abaixo da qual o eixo volta ao neutro
+#define joystick_hysteresis_default 300 // Distância extra, além da zona morta, para o eixo sair do neutro
+
+typedef enum {
+    joystick_center,
+    joystick_up,
+    joystick_up_right,
+    joystick_right,
+    joystick_down_right,
+    joystick_down,
+    joystick_down_left,
+    joystick_left,
+    joystick_up_left,
+    joystick_directions
+} joystick_direction_t;
+
+// Chamada na interrupção do DMA a cada mudança de direção (use apenas funções ...FromISR)
+typedef void (*joystick_callback_t)(joystick_direction_t direction, void *user_data);
+
+extern void joystick_init(uint x_input, uint y_input, uint16_t deadzone, uint16_t hysteresis,
+                          joystick_callback_t callback, void *user_data);
+extern joystick_direction_t joystick_direction(void);
+extern const char *joystick_direction_name(joystick_direction_t direction);
+
+#endif
@@ -0,0 +1,74 @@
+#include <string.h>
+#include "hardware/sync.h"
+#include "mailbox.h"
+
+// Prepara a caixa para valores de size bytes (até mailbox_max_size), com o valor inicial dado
+void mailbox_init(mailbox_t *box, size_t size, const void *initial) {
+    box->size = size <= mailbox_max_size ? size : mailbox_max_size;
+    memcpy(box->data[0], initial, box->size);
+    box->sequence = 0;
+}
+
+// Publica um novo valor. Só um contexto pode escrever em cada caixa
+void mailbox_write(mailbox_t *box, const void *value) {
+    uint32_t next = box->sequence + 1;
+    memcpy(box->data[next & 1], value, box->size);
+    __dmb(); // A cópia precisa estar completa antes de ser publicada
+    box->sequence = next;
+}
+
+// Copia o valor mais recente para value e retorna o seu número de sequência (muda a cada
+// escrita). Se o escritor publicar duas vezes durante a cópia, a cópia lida pode ter sido
+// sobrescrita; nesse caso a sequência terá mudado e a leitura é refeita
+uint32_t mailbox_read(const mailbox_t *box, void *value) {
+    for (;;) {
+        uint32_t sequence = box->sequence;
+        __dmb();
+        memcpy(value, box->data[sequence & 1], box->size);
+        __dmb();
+        if (box->sequence == sequence) {
+            return sequence;
+        }
+    }
+}
+
+// Publica de uma vez um grupo de caixas (values em sequência, cada um com o tamanho da sua caixa).
+// O grupo tem um único número de sequência, o da primeira caixa: todas recebem a cópia da mesma
+// paridade e a primeira é publicada por último. As caixas de um grupo só podem ser escritas por aqui
+void mailbox_write_group(mailbox_t *boxes, uint count, const void *values) {
+    const uint8_t *value = values;
+    uint32_t next = boxes[0].sequence + 1;
+    for (uint i = 0; i < count; i++) {
+        memcpy(boxes[i].data[next & 1], value, boxes[i].size);
+        value += boxes[i].size;
+    }
+    __dmb(); // Todas as cópias completas antes de qualquer publicação
+    for (uint i = count - 1; i > 0; i--) {
+        boxes[i].sequence = next;
+    }
+    boxes[0].sequence = next;
+}
+
+// Lê um grupo publicado por mailbox_write_group e retorna a sequência do grupo. Como numa caixa
+// só, a leitura só é refeita se uma escrita inteira do grupo terminou no meio dela: um leitor que
+// interrompe o escritor no meio do grupo ainda vê a sequência anterior e lê as cópias antigas
+uint32_t mailbox_read_group(const mailbox_t *boxes, uint count, void *values) {
+    for (;;) {
+        uint32_t sequence = boxes[0].sequence;
+        __dmb();
+        uint8_t *value = values;
+        for (uint i = 0; i < count; i++) {
+            memcpy(value, boxes[i].data[sequence & 1], boxes[i].size);
+            value += boxes[i].size;
+        }
+        __dmb();
+        if (boxes[0].sequence == sequence) {
+            return sequence;
+        }
+    }
+}
+
+// Número de sequência atual, para saber se houve escrita sem copiar o valor
+uint32_t mailbox_sequence(const mailbox_t *box) {
+    return box->sequence;
+}
@@ -0,0 +1,33 @@
+#ifndef mailbox_h
+#define mailbox_h
+
+#include <stddef.h>
+#include "pico/stdlib.h"
+
+// Caixa de correio do valor mais recente, sem trava, para um único escritor e qualquer número
+// de leitores (tarefas, interrupções ou o outro núcleo). O valor fica em duas cópias: o escritor
+// preenche a cópia que ninguém está lendo e só então publica o novo número de sequência, então
+// ele nunca espera e o leitor só repete a leitura se uma escrita inteira terminou no meio dela.
+// Valores maiores que uma caixa vão num grupo de caixas com um só número de sequência
+// (mailbox_write_group/mailbox_read_group), com a mesma garantia
+
+#define mailbox_max_size 16 // Maior valor guardado (bytes)
+
+typedef struct {
+    volatile uint32_t sequence; // Escritas publicadas; a cópia atual é data[sequence & 1]
+    uint8_t size;
+    uint8_t data[2][mailbox_max_size] __attribute__((aligned(4)));
+} mailbox_t;
+
+// Inicializador estático: a caixa já pode ser lida (valor zerado) antes de mailbox_init ou da
+// primeira escrita, mesmo que o escritor nunca chegue a ser iniciado
+#define mailbox_initializer(value_size) {.sequence = 0, .size = (value_size)}
+
+extern void mailbox_init(mailbox_t *box, size_t size, const void *initial);
+extern void mailbox_write(mailbox_t *box, const void *value);
+extern uint32_t mailbox_read(const mailbox_t *box, void *value);
+extern void mailbox_write_group(mailbox_t *boxes, uint count, const void *values);
+extern uint32_t mailbox_read_group(const mailbox_t *boxes, uint count, void *values);
+extern uint32_t mailbox_sequence(const mailbox_t *box);
+
+#endif
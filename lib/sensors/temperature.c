@@ -0,0 +1,221 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "adc_sampler.h"
+#include "temperature.h"
+
+// Reta do sensor em ponto fixo Q14, para o código de 16 bits (0 a 65535 = 0 a vref):
+//   T = 27 °C - (V - V27) / inclinação  ->  T[centésimos] = (offset - código * slope) / 2^14
+// com slope = vref * 100000 / (65536 * inclinação) centésimos por unidade de código. Como
+// 2^14 / 65536 = 1/4, as duas constantes saem exatas (arredondadas) em inteiros. O slope leva
+// mais 12 bits de fração (Q26), aplicados numa segunda multiplicação: só com a parte Q14 o
+// arredondamento acumularia ~1 centésimo no fim da escala
+#define temperature_slope_q26 \
+    ((((uint64_t)temperature_vref_mv * 100000 << 12) + 2 * temperature_slope_uv) / (4 * temperature_slope_uv))
+#define temperature_slope_q14 (temperature_slope_q26 >> 12)
+#define temperature_slope_fraction (temperature_slope_q26 & 0xFFF)
+#define temperature_offset_q14 \
+    ((((uint64_t)2700 * temperature_slope_uv + (uint64_t)temperature_v27_uv * 100) * 16384 + temperature_slope_uv / 2) / temperature_slope_uv)
+
+#define temperature_calibration_magic 0x54454D50u // "TEMP"
+#define temperature_command_max 24                 // Maior linha de comando aceita pela serial
+
+// Registro gravado no início do setor de calibração
+typedef struct {
+    uint32_t magic;
+    int32_t offset_centi; // Somado a cada leitura
+    uint32_t check;       // ~offset_centi: descarta setor apagado ou gravação incompleta
+} temperature_calibration_t;
+
+static temperature_filter_t filter;
+static volatile int32_t filtered_centi; // Saída do filtro, sem o ajuste de calibração
+static volatile int32_t calibration_centi;
+
+// Converte o código sobreamostrado de 16 bits em centésimos de grau (sem calibração).
+// Os dois produtos cabem em 32 bits sem sinal; só a subtração usa 64 bits (soma com carry no M0+)
+int32_t temperature_centi_from_code(uint32_t code) {
+    if (code > 0xFFFF) {
+        code = 0xFFFF;
+    }
+    uint32_t product = code * (uint32_t)temperature_slope_q14 +
+                       ((code * (uint32_t)temperature_slope_fraction + (1 << 11)) >> 12);
+    int64_t centi_q14 = (int64_t)temperature_offset_q14 - product + (1 << 13);
+    return (int32_t)(centi_q14 >> 14);
+}
+
+// Converte uma leitura simples de 12 bits do ADC
+int32_t temperature_centi_from_raw(uint16_t raw) {
+    return temperature_centi_from_code((uint32_t)raw << 4);
+}
+
+void temperature_filter_init(temperature_filter_t *filter, uint8_t shift) {
+    filter->state = 0;
+    filter->shift = shift;
+    filter->primed = false;
+}
+
+// Acrescenta uma amostra ao filtro e devolve a saída em centésimos de grau
+int32_t temperature_filter_update(temperature_filter_t *filter, int32_t centi) {
+    int32_t input = centi * (1 << temperature_filter_frac);
+    if (!filter->primed) {
+        filter->state = input;
+        filter->primed = true;
+    }
+    else {
+        filter->state += (input - filter->state) >> filter->shift;
+    }
+    return (filter->state + (1 << (temperature_filter_frac - 1))) >> temperature_filter_frac;
+}
+
+// Chamada pelo adc_sampler a cada bloco: a taxa fixa dá ao filtro uma constante de tempo fixa
+static void temperature_block(void *user_data) {
+    (void)user_data;
+    int32_t centi = temperature_centi_from_code(adc_sampler_oversampled(adc_sampler_temperature_input));
+    filtered_centi = temperature_filter_update(&filter, centi);
+}
+
+// Liga a leitura contínua da temperatura. O adc_sampler já deve estar amostrando a entrada 4.
+// Carrega a calibração da flash (0 se o setor não tiver uma válida)
+void temperature_init(uint8_t filter_shift) {
+    const temperature_calibration_t *stored =
+        (const temperature_calibration_t *)(XIP_BASE + temperature_calibration_flash_offset);
+    if (stored->magic == temperature_calibration_magic && stored->check == ~(uint32_t)stored->offset_centi) {
+        calibration_centi = stored->offset_centi;
+    }
+
+    temperature_filter_init(&filter, filter_shift);
+    temperature_block(NULL);
+    adc_sampler_add_callback(temperature_block, NULL);
+}
+
+// Temperatura filtrada e calibrada, em centésimos de grau
+int32_t temperature_read_centi(void) {
+    return filtered_centi + calibration_centi;
+}
+
+int32_t temperature_calibration_offset(void) {
+    return calibration_centi;
+}
+
+// Apaga o setor de calibração e grava a página com o novo registro (com a XIP parada)
+static void temperature_flash_write(void *page) {
+    flash_range_erase(temperature_calibration_flash_offset, FLASH_SECTOR_SIZE);
+    flash_range_program(temperature_calibration_flash_offset, page, FLASH_PAGE_SIZE);
+}
+
+// Ajusta a placa para que a leitura atual corresponda à temperatura de referência (medida
+// por um termômetro) e grava o ajuste na flash. flash_safe_execute pausa o outro núcleo e o
+// escalonador enquanto a flash não pode ser lida. Retorna false se a gravação falhou
+bool temperature_calibrate(int32_t reference_centi) {
+    int32_t offset = reference_centi - filtered_centi;
+
+    uint8_t page[FLASH_PAGE_SIZE];
+    temperature_calibration_t record = {
+        .magic = temperature_calibration_magic,
+        .offset_centi = offset,
+        .check = ~(uint32_t)offset,
+    };
+    memset(page, 0xFF, sizeof(page));
+    memcpy(page, &record, sizeof(record));
+
+    if (flash_safe_execute(temperature_flash_write, page, UINT32_MAX) != PICO_OK) {
+        return false;
+    }
+    calibration_centi = offset;
+    return true;
+}
+
+// Arredonda centésimos para a unidade pedida (10: décimos, 100: graus), afastando do zero
+int32_t temperature_round(int32_t centi, int32_t unit) {
+    return (centi >= 0 ? centi + unit / 2 : centi - unit / 2) / unit;
+}
+
+// Escreve a temperatura com duas casas decimais (ex.: "-3.05"), sem printf de ponto flutuante
+int temperature_format(char *buffer, size_t size, int32_t centi) {
+    uint32_t magnitude = centi < 0 ? -(uint32_t)centi : (uint32_t)centi;
+    return snprintf(buffer, size, "%s%lu.%02lu", centi < 0 ? "-" : "",
+                    (unsigned long)(magnitude / 100), (unsigned long)(magnitude % 100));
+}
+
+// Lê "25.3", "-4" ou "27.05" (até duas casas) em centésimos de grau, sem ponto flutuante
+bool temperature_parse_centi(const char *text, int32_t *centi) {
+    bool negative = *text == '-';
+    if (*text == '-' || *text == '+') {
+        text++;
+    }
+    if (!isdigit((unsigned char)*text)) {
+        return false;
+    }
+
+    int32_t value = 0;
+    while (isdigit((unsigned char)*text) && value < 100000) {
+        value = value * 10 + (*text++ - '0');
+    }
+    value *= 100;
+    if (*text == '.' || *text == ',') {
+        text++;
+        for (int32_t unit = 10; unit > 0 && isdigit((unsigned char)*text); unit /= 10) {
+            value += (*text++ - '0') * unit;
+        }
+        while (isdigit((unsigned char)*text)) {
+            text++;
+        }
+    }
+    if (*text != '\0') {
+        return false;
+    }
+
+    *centi = negative ? -value : value;
+    return true;
+}
+
+// Executa uma linha de provisionamento: "cal <graus>" grava na flash o ajuste que faz a leitura
+// atual valer a temperatura de um termômetro de referência; "cal" mostra o ajuste gravado.
+// Retorna false (com a ajuda impressa) se a linha não é um desses comandos
+bool temperature_calibration_command(const char *line) {
+    char text[12];
+    int32_t reference;
+
+    if (strcmp(line, "cal") == 0) {
+        temperature_format(text, sizeof(text), calibration_centi);
+        printf("Ajuste de temperatura: %s C\n", text);
+        return true;
+    }
+    if (strncmp(line, "cal ", 4) == 0 && temperature_parse_centi(line + 4, &reference)) {
+        if (temperature_calibrate(reference)) {
+            temperature_format(text, sizeof(text), calibration_centi);
+            printf("Calibrado: ajuste de %s C gravado na flash\n", text);
+        }
+        else {
+            printf("Falha ao gravar a calibracao\n");
+        }
+        return true;
+    }
+    if (line[0] != '\0') {
+        printf("Comandos: cal | cal <graus>\n");
+    }
+    return false;
+}
+
+// Lê sem bloquear os caracteres já recebidos pela stdio (USB ou UART) e executa cada linha
+// completa com temperature_calibration_command. Chamada periodicamente pelo laço principal ou
+// por uma tarefa de baixa prioridade; a pilha precisa comportar uma página da flash
+void temperature_calibration_poll(void) {
+    static char line[temperature_command_max];
+    static size_t length;
+
+    for (int c = getchar_timeout_us(0); c != PICO_ERROR_TIMEOUT; c = getchar_timeout_us(0)) {
+        if (c != '\r' && c != '\n') {
+            if (length < sizeof(line) - 1) {
+                line[length++] = (char)c;
+            }
+            continue;
+        }
+        line[length] = '\0';
+        length = 0;
+        temperature_calibration_command(line);
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef temperature_h
+#define temperature_h
+
+#include <stddef.h>
+#include "pico/stdlib.h"
+
+// Temperatura do sensor interno do RP2040 em centésimos de grau, só com aritmética inteira
+// (o RP2040 não tem FPU). O código sobreamostrado do ADC (16 bits, adc_sampler_oversampled)
+// é convertido por uma reta em ponto fixo, somado ao ajuste de calibração da placa (gravado na
+// flash) e suavizado por um filtro IIR atualizado a cada bloco do adc_sampler
+
+// Constantes do datasheet do RP2040 (sensor de temperatura): 0,706 V a 27 °C, -1,721 mV/°C,
+// com referência de 3,3 V
+#define temperature_vref_mv 3300
+#define temperature_v27_uv 706000
+#define temperature_slope_uv 1721
+
+#define temperature_filter_shift_default 6 // Cada bloco pesa 1/64: ~1 s de constante de tempo a 62,5 blocos/s
+#define temperature_filter_frac 8          // Bits de fração guardados no estado do filtro
+
+// Setor da flash que guarda a calibração (o último, por padrão)
+#ifndef temperature_calibration_flash_offset
+#define temperature_calibration_flash_offset (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+#endif
+
+// Filtro passa-baixas de primeira ordem: y += (x - y) / 2^shift
+typedef struct {
+    int32_t state; // Saída em centésimos de grau, com temperature_filter_frac bits de fração
+    uint8_t shift;
+    bool primed;   // false: a próxima entrada inicializa o estado (sem rampa a partir de 0)
+} temperature_filter_t;
+
+extern int32_t temperature_centi_from_code(uint32_t code);
+extern int32_t temperature_centi_from_raw(uint16_t raw);
+extern void temperature_filter_init(temperature_filter_t *filter, uint8_t shift);
+extern int32_t temperature_filter_update(temperature_filter_t *filter, int32_t centi);
+extern void temperature_init(uint8_t filter_shift);
+extern int32_t temperature_read_centi(void);
+extern int32_t temperature_calibration_offset(void);
+extern bool temperature_calibrate(int32_t reference_centi);
+extern int32_t temperature_round(int32_t centi, int32_t unit);
+extern int temperature_format(char *buffer, size_t size, int32_t centi);
+extern bool temperature_parse_centi(const char *text, int32_t *centi);
+extern bool temperature_calibration_command(const char *line);
+extern void temperature_calibration_poll(void);
+
+#endif
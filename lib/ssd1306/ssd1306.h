@@ -0,0 +1,42 @@
+#include "ssd1306_i2c.h"
+#include "ssd1306_fonts.h"
+extern void calculate_render_area_buffer_length(struct render_area *area);
+extern void ssd1306_command(ssd1306_t *ssd, uint8_t command);
+extern void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, int number);
+extern void ssd1306_config(ssd1306_t *ssd);
+extern void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
+extern void ssd1306_scroll(ssd1306_t *ssd, bool set);
+extern void ssd1306_start_scroll(ssd1306_t *ssd, int start_page, int end_page, bool left, uint8_t interval, uint8_t vertical_offset);
+extern void ssd1306_stop_scroll(ssd1306_t *ssd);
+extern void ssd1306_mark_dirty(ssd1306_t *ssd, int x_0, int y_0, int x_1, int y_1);
+extern void ssd1306_clear(ssd1306_t *ssd);
+extern void render_on_display(ssd1306_t *ssd, struct render_area *area);
+extern void ssd1306_send_data(ssd1306_t *ssd);
+extern bool ssd1306_is_dirty(ssd1306_t *ssd);
+extern void render_dirty_on_display(ssd1306_t *ssd);
+extern void ssd1306_async_init(ssd1306_t *ssd);
+extern void render_on_display_async(ssd1306_t *ssd, ssd1306_flush_callback_t callback, void *user_data);
+extern bool ssd1306_flush_busy(ssd1306_t *ssd);
+extern void ssd1306_flush_wait(ssd1306_t *ssd);
+#if SSD1306_STATS
+extern void ssd1306_stats_get(ssd1306_t *ssd, ssd1306_stats_t *stats);
+extern void ssd1306_stats_reset(ssd1306_t *ssd);
+#endif
+extern void ssd1306_set_pixel(ssd1306_t *ssd, int x, int y, bool set);
+extern void ssd1306_fill_rect(ssd1306_t *ssd, int x, int y, int width, int height, bool set);
+extern void ssd1306_clear_rect(ssd1306_t *ssd, int x, int y, int width, int height);
+extern void ssd1306_hline(ssd1306_t *ssd, int x, int y, int width, bool set);
+extern void ssd1306_vline(ssd1306_t *ssd, int x, int y, int height, bool set);
+extern void ssd1306_rect(ssd1306_t *ssd, int x, int y, int width, int height, bool set);
+extern void ssd1306_draw_line(ssd1306_t *ssd, int x_0, int y_0, int x_1, int y_1, bool set);
+extern void ssd1306_draw_char(ssd1306_t *ssd, int16_t x, int16_t y, uint8_t character);
+extern void ssd1306_draw_string(ssd1306_t *ssd, int16_t x, int16_t y, const char *string);
+extern void ssd1306_draw_char_column(ssd1306_t *ssd, int x, int y, uint8_t character, int column);
+extern uint8_t ssd1306_next_char(const char **string);
+extern void ssd1306_draw_char_scaled(ssd1306_t *ssd, int16_t x, int16_t y, uint8_t character, int scale);
+extern void ssd1306_draw_string_scaled(ssd1306_t *ssd, int16_t x, int16_t y, const char *string, int scale);
+extern int ssd1306_text_width(const ssd1306_font_t *font, const char *string);
+extern int ssd1306_draw_text(ssd1306_t *ssd, const ssd1306_font_t *font, int x, int y, const char *string);
+extern void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap);
+extern void ssd1306_blit_bitmap(ssd1306_t *ssd, const uint8_t *bitmap, int x, int y, int width, int height);
+extern void ssd1306_draw_bitmap_area(ssd1306_t *ssd, const uint8_t *bitmap, int x, int y, int width, int height);
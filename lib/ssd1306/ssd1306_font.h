@@ -46,4 +46,37 @@ static uint8_t font[] = {
     0x00, 0x00, 0x00, 0x00, 0x10, 0x30, 0x20, 0x00, // , (vírgula)
     0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, // . (ponto final)
     0x06, 0x09, 0x09, 0x06, 0x00, 0x00, 0x00, 0x00 // ° (grau)
-};
\ No newline at end of file
+};
+
+// Índice do glifo em font[] para cada caractere Latin-1 (0 = em branco).
+// Minúsculas usam o glifo maiúsculo; letras acentuadas sem glifo próprio usam a letra base
+#define font_letter(c) [c] = (c) - 'A' + 1, [(c) + 32] = (c) - 'A' + 1
+#define font_accent(c, base) [c] = (base) - 'A' + 1, [(c) + 32] = (base) - 'A' + 1
+
+static const uint8_t font_index[256] = {
+    font_letter('A'), font_letter('B'), font_letter('C'), font_letter('D'), font_letter('E'),
+    font_letter('F'), font_letter('G'), font_letter('H'), font_letter('I'), font_letter('J'),
+    font_letter('K'), font_letter('L'), font_letter('M'), font_letter('N'), font_letter('O'),
+    font_letter('P'), font_letter('Q'), font_letter('R'), font_letter('S'), font_letter('T'),
+    font_letter('U'), font_letter('V'), font_letter('W'), font_letter('X'), font_letter('Y'),
+    font_letter('Z'),
+
+    ['0'] = 27, ['1'] = 28, ['2'] = 29, ['3'] = 30, ['4'] = 31,
+    ['5'] = 32, ['6'] = 33, ['7'] = 34, ['8'] = 35, ['9'] = 36,
+
+    ['-'] = 37, ['+'] = 40, [':'] = 41, [','] = 43, ['.'] = 44,
+    [0xC7] = 38, [0xE7] = 38, // Ç ç
+    [0xC3] = 39, [0xE3] = 39, // Ã ã
+    [0xBA] = 42,              // º (ordinal masculino)
+    [0xB0] = 45,              // ° (grau)
+
+    font_accent(0xC0, 'A'), font_accent(0xC1, 'A'), font_accent(0xC2, 'A'), font_accent(0xC4, 'A'), // À Á Â Ä
+    font_accent(0xC8, 'E'), font_accent(0xC9, 'E'), font_accent(0xCA, 'E'), font_accent(0xCB, 'E'), // È É Ê Ë
+    font_accent(0xCC, 'I'), font_accent(0xCD, 'I'), font_accent(0xCE, 'I'), font_accent(0xCF, 'I'), // Ì Í Î Ï
+    font_accent(0xD2, 'O'), font_accent(0xD3, 'O'), font_accent(0xD4, 'O'), font_accent(0xD5, 'O'), // Ò Ó Ô Õ
+    font_accent(0xD6, 'O'), font_accent(0xD9, 'U'), font_accent(0xDA, 'U'), font_accent(0xDB, 'U'), // Ö Ù Ú Û
+    font_accent(0xDC, 'U'), font_accent(0xD1, 'N'), font_accent(0xDD, 'Y'),                         // Ü Ñ Ý
+};
+
+#undef font_letter
+#undef font_accent
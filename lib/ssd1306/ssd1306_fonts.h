@@ -0,0 +1,28 @@
+#ifndef ssd1306_fonts_h
+#define ssd1306_fonts_h
+
+#include <stdint.h>
+
+// Fontes geradas na compilação (tools/bdf2ssd1306.py) a partir dos arquivos BDF de fonts/.
+// Os glifos ficam na flash no formato de ram_buffer: colunas de 8 pixels (bit 0 no topo),
+// página a página, com a altura arredondada para páginas inteiras. Desenhar um glifo é copiar
+// bytes (deslocados quando y não é múltiplo de 8), sem tratar pixel a pixel
+
+typedef struct {
+    uint16_t offset; // Primeiro byte do glifo em bitmap
+    uint8_t width;   // Colunas do glifo, já incluindo o espaço até o próximo (avanço)
+} ssd1306_glyph_t;
+
+typedef struct {
+    const uint8_t *bitmap;         // Glifos em sequência, cada um com height / 8 páginas de width bytes
+    const ssd1306_glyph_t *glyphs; // glyphs[0] substitui os caracteres que a fonte não tem
+    const uint8_t *index;          // Caractere Latin-1 -> glifo
+    uint8_t height;                // Altura da célula em pixels
+    uint8_t baseline;              // Linhas acima da linha de base
+} ssd1306_font_t;
+
+extern const ssd1306_font_t ssd1306_font_text7; // Texto proporcional: 7 pixels + 1 de descendente
+extern const ssd1306_font_t ssd1306_font_num16; // Algarismos de 16 pixels (0-9 + - . , : ° C)
+extern const ssd1306_font_t ssd1306_font_num24; // Algarismos de 24 pixels (0-9 + - . , : ° C)
+
+#endif
@@ -0,0 +1,892 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "pico/binary_info.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "ssd1306_font.h"
+#include "ssd1306_i2c.h"
+#include "ssd1306.h"
+
+// Contadores de barramento: sem SSD1306_STATS as macros não geram código
+#if SSD1306_STATS
+#define ssd1306_stats_bus(ssd, length, count) do { (ssd)->stats.bytes += (length); (ssd)->stats.transactions += (count); } while (0)
+#define ssd1306_stats_begin() uint32_t stats_start = time_us_32()
+#define ssd1306_stats_flush(ssd) do { (ssd)->stats.flushes++; (ssd)->stats.flush_us += time_us_32() - stats_start; } while (0)
+#else
+#define ssd1306_stats_bus(ssd, length, count) do { } while (0)
+#define ssd1306_stats_begin() do { } while (0)
+#define ssd1306_stats_flush(ssd) do { } while (0)
+#endif
+
+// Display com envio assíncrono ativo em cada barramento I2C (um por barramento)
+static ssd1306_t *async_displays[NUM_I2CS];
+
+// Calcular quanto do buffer será destinado à área de renderização
+void calculate_render_area_buffer_length(struct render_area *area) {
+    area->buffer_length = (area->end_column - area->start_column + 1) * (area->end_page - area->start_page + 1);
+}
+
+// Aguarda a FIFO de TX esvaziar e o controlador terminar a transação em andamento (STOP enviado)
+static void ssd1306_i2c_wait_idle(i2c_hw_t *hw) {
+    while (!(hw->status & I2C_IC_STATUS_TFE_BITS) || (hw->status & I2C_IC_STATUS_ACTIVITY_BITS)) {
+        tight_loop_contents();
+    }
+}
+
+// Aguarda o fim de qualquer envio assíncrono no barramento, inclusive os bytes ainda na FIFO do I2C
+static void ssd1306_bus_wait(i2c_inst_t *i2c) {
+    ssd1306_t *owner = async_displays[i2c_get_index(i2c)];
+    if (owner == NULL) {
+        return;
+    }
+
+    while (owner->async->active != -1 || owner->async->pending != -1) {
+        tight_loop_contents();
+    }
+
+    ssd1306_i2c_wait_idle(i2c_get_hw(i2c));
+}
+
+// Processo de escrita do i2c espera um byte de controle, seguido por dados
+void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
+    ssd1306_bus_wait(ssd->i2c_port);
+
+    ssd->port_buffer[1] = command;
+    i2c_write_blocking(ssd->i2c_port, ssd->address, ssd->port_buffer, 2, false);
+    ssd1306_stats_bus(ssd, 2, 1);
+}
+
+// Envia uma lista de comandos numa única transação I2C: o byte de controle 0x00
+// (Co = 0) indica que todos os bytes seguintes, até o STOP, são comandos
+void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, int number) {
+    uint8_t buffer[ssd1306_command_stream_max + 1];
+    buffer[0] = ssd1306_control_command;
+
+    ssd1306_bus_wait(ssd->i2c_port);
+
+    while (number > 0) {
+        int chunk = number < ssd1306_command_stream_max ? number : ssd1306_command_stream_max;
+
+        memcpy(buffer + 1, commands, chunk);
+        i2c_write_blocking(ssd->i2c_port, ssd->address, buffer, chunk + 1, false);
+        ssd1306_stats_bus(ssd, chunk + 1, 1);
+
+        commands += chunk;
+        number -= chunk;
+    }
+}
+
+// Cria a lista de comandos (com base nos endereços definidos em ssd1306_i2c.h) para a inicialização do display
+void ssd1306_config(ssd1306_t *ssd) {
+    uint8_t commands[] = {
+        ssd1306_set_display, ssd1306_set_memory_mode, 0x00,
+        ssd1306_set_display_start_line, ssd1306_set_segment_remap | 0x01,
+        ssd1306_set_mux_ratio, ssd->height - 1,
+        ssd1306_set_common_output_direction | 0x08, ssd1306_set_display_offset,
+        0x00, ssd1306_set_common_pin_configuration,
+        (ssd->width == 128 && ssd->height == 64) ? 0x12 : 0x02,
+        ssd1306_set_display_clock_divide_ratio, 0x80, ssd1306_set_precharge,
+        ssd->external_vcc ? 0x22 : 0xF1, ssd1306_set_vcomh_deselect_level, 0x30, ssd1306_set_contrast,
+        0xFF, ssd1306_set_entire_on, ssd1306_set_normal_display,
+        ssd1306_set_charge_pump, ssd->external_vcc ? 0x10 : 0x14, ssd1306_set_scroll | 0x00,
+        ssd1306_set_display | 0x01,
+    };
+
+    ssd1306_command_list(ssd, commands, count_of(commands));
+}
+
+// Inicializa a instância (barramento, endereço e geometria), aloca o framebuffer e configura o display
+void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
+    assert(height / 8U <= ssd1306_max_pages);
+
+    memset(ssd, 0, sizeof(*ssd));
+    ssd->width = width;
+    ssd->height = height;
+    ssd->pages = height / 8U;
+    ssd->address = address;
+    ssd->i2c_port = i2c;
+    ssd->external_vcc = external_vcc;
+    ssd->bufsize = ssd->pages * ssd->width + 1;
+    ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+    ssd->ram_buffer[0] = ssd1306_control_data;
+    ssd->port_buffer[0] = 0x80;
+
+    ssd1306_config(ssd);
+}
+
+// Rolagem por hardware das páginas [start_page, end_page]: o próprio controlador desloca o
+// conteúdo (com retorno circular nas 128 colunas da GDDRAM), sem tráfego I2C por passo.
+// vertical_offset > 0 combina cada passo horizontal com um deslocamento vertical da tela
+// inteira (comandos 0x29/0x2A, com a área de rolagem vertical em 0xA3)
+void ssd1306_start_scroll(ssd1306_t *ssd, int start_page, int end_page, bool left, uint8_t interval, uint8_t vertical_offset) {
+    uint8_t *commands = ssd->scroll_commands;
+    int n = 0;
+
+    if (vertical_offset) {
+        commands[n++] = ssd1306_set_vertical_scroll_area;
+        commands[n++] = 0;
+        commands[n++] = ssd->height;
+        commands[n++] = ssd1306_set_vertical_horizontal_scroll | (left ? 0x03 : 0x00);
+        commands[n++] = 0x00;
+        commands[n++] = start_page;
+        commands[n++] = interval;
+        commands[n++] = end_page;
+        commands[n++] = vertical_offset % ssd->height;
+    }
+    else {
+        commands[n++] = ssd1306_set_horizontal_scroll | (left ? 0x01 : 0x00);
+        commands[n++] = 0x00;
+        commands[n++] = start_page;
+        commands[n++] = interval;
+        commands[n++] = end_page;
+        commands[n++] = 0x00;
+        commands[n++] = 0xFF;
+    }
+    commands[n++] = ssd1306_set_scroll | 0x01;
+    ssd->scroll_length = n;
+
+    // A configuração só é aceita com a rolagem desativada
+    ssd1306_command(ssd, ssd1306_set_scroll | 0x00);
+    ssd1306_command_list(ssd, commands, n);
+}
+
+// Encerra a rolagem por hardware. A GDDRAM ficou deslocada, então a tela é reenviada
+void ssd1306_stop_scroll(ssd1306_t *ssd) {
+    ssd->scroll_length = 0;
+    ssd1306_command(ssd, ssd1306_set_scroll | 0x00);
+    ssd1306_send_data(ssd);
+}
+
+// Liga ou desliga a rolagem horizontal da tela inteira
+void ssd1306_scroll(ssd1306_t *ssd, bool set) {
+    if (set) {
+        ssd1306_start_scroll(ssd, 0, ssd->pages - 1, false, ssd1306_scroll_frames_5, 0);
+    }
+    else {
+        ssd1306_stop_scroll(ssd);
+    }
+}
+
+// Acrescenta as colunas [x_0, x_1] à faixa alterada de uma página
+static inline void ssd1306_mark_page_dirty(ssd1306_t *ssd, int page, int x_0, int x_1) {
+    if (ssd->dirty_start[page] == ssd->dirty_end[page]) {
+        ssd->dirty_start[page] = x_0;
+        ssd->dirty_end[page] = x_1 + 1;
+        return;
+    }
+    if (x_0 < ssd->dirty_start[page]) {
+        ssd->dirty_start[page] = x_0;
+    }
+    if (x_1 >= ssd->dirty_end[page]) {
+        ssd->dirty_end[page] = x_1 + 1;
+    }
+}
+
+// Marca como alterada a região entre (x_0, y_0) e (x_1, y_1), limitada à tela
+void ssd1306_mark_dirty(ssd1306_t *ssd, int x_0, int y_0, int x_1, int y_1) {
+    if (x_0 < 0) x_0 = 0;
+    if (y_0 < 0) y_0 = 0;
+    if (x_1 > ssd->width - 1) x_1 = ssd->width - 1;
+    if (y_1 > ssd->height - 1) y_1 = ssd->height - 1;
+    if (x_0 > x_1 || y_0 > y_1) {
+        return;
+    }
+
+    for (int page = y_0 / 8; page <= y_1 / 8; page++) {
+        ssd1306_mark_page_dirty(ssd, page, x_0, x_1);
+    }
+}
+
+// Apaga todo o framebuffer e marca a tela inteira como alterada
+void ssd1306_clear(ssd1306_t *ssd) {
+    memset(ssd->ram_buffer + 1, 0, ssd->bufsize - 1);
+    ssd1306_mark_dirty(ssd, 0, 0, ssd->width - 1, ssd->height - 1);
+}
+
+// Descarta as alterações pendentes que ficaram dentro da área já enviada ao display
+static void ssd1306_clear_dirty(ssd1306_t *ssd, struct render_area *area) {
+    for (int page = area->start_page; page <= area->end_page && page < ssd->pages; page++) {
+        if (ssd->dirty_start[page] >= area->start_column && ssd->dirty_end[page] <= area->end_column + 1) {
+            ssd->dirty_start[page] = ssd->dirty_end[page] = 0;
+        }
+    }
+}
+
+// Envia uma janela contígua do framebuffer (uma página, ou páginas inteiras). O byte
+// imediatamente anterior à janela é usado como byte de controle e restaurado em seguida
+static void ssd1306_send_window(ssd1306_t *ssd, struct render_area *area) {
+    uint8_t commands[] = {
+        ssd1306_set_column_address, area->start_column, area->end_column,
+        ssd1306_set_page_address, area->start_page, area->end_page
+    };
+
+    ssd1306_command_list(ssd, commands, count_of(commands));
+
+    uint8_t *slot = ssd->ram_buffer + area->start_page * ssd->width + area->start_column;
+    uint8_t saved = *slot;
+    *slot = ssd1306_control_data;
+    i2c_write_blocking(ssd->i2c_port, ssd->address, slot, area->buffer_length + 1, false);
+    *slot = saved;
+    ssd1306_stats_bus(ssd, area->buffer_length + 1, 1);
+
+    ssd1306_clear_dirty(ssd, area);
+}
+
+// Com a rolagem por hardware ativa o controlador já deslocou a GDDRAM e não aceita escrita
+// durante a rolagem: ela é suspensa, a tela inteira é reenviada e a rolagem recomeça
+static void ssd1306_send_while_scrolling(ssd1306_t *ssd) {
+    struct render_area area = {
+        .start_column = 0,
+        .end_column = ssd->width - 1,
+        .start_page = 0,
+        .end_page = ssd->pages - 1
+    };
+    calculate_render_area_buffer_length(&area);
+    ssd1306_stats_begin();
+
+    ssd1306_command(ssd, ssd1306_set_scroll | 0x00);
+    ssd1306_send_window(ssd, &area);
+    ssd1306_command_list(ssd, ssd->scroll_commands, ssd->scroll_length);
+    ssd1306_stats_flush(ssd);
+}
+
+// Atualiza uma parte do display com uma área de renderização, direto do framebuffer
+void render_on_display(ssd1306_t *ssd, struct render_area *area) {
+    if (ssd->scroll_length) {
+        ssd1306_send_while_scrolling(ssd);
+        return;
+    }
+    ssd1306_stats_begin();
+
+    // Janelas com a largura toda são contíguas no framebuffer; as demais são enviadas página a página
+    if (area->start_column == 0 && area->end_column == ssd->width - 1) {
+        calculate_render_area_buffer_length(area);
+        ssd1306_send_window(ssd, area);
+        ssd1306_stats_flush(ssd);
+        return;
+    }
+
+    for (int page = area->start_page; page <= area->end_page; page++) {
+        struct render_area page_area = {
+            .start_column = area->start_column,
+            .end_column = area->end_column,
+            .start_page = page,
+            .end_page = page
+        };
+        calculate_render_area_buffer_length(&page_area);
+
+        ssd1306_send_window(ssd, &page_area);
+    }
+    ssd1306_stats_flush(ssd);
+}
+
+// Envia a tela inteira ao display
+void ssd1306_send_data(ssd1306_t *ssd) {
+    struct render_area area = {
+        .start_column = 0,
+        .end_column = ssd->width - 1,
+        .start_page = 0,
+        .end_page = ssd->pages - 1
+    };
+
+    render_on_display(ssd, &area);
+}
+
+// Indica se alguma região do framebuffer mudou desde o último envio
+bool ssd1306_is_dirty(ssd1306_t *ssd) {
+    for (int page = 0; page < ssd->pages; page++) {
+        if (ssd->dirty_start[page] != ssd->dirty_end[page]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Envia apenas as janelas (página/colunas) alteradas desde o último envio
+void render_dirty_on_display(ssd1306_t *ssd) {
+    if (!ssd1306_is_dirty(ssd)) {
+        return;
+    }
+    if (ssd->scroll_length) {
+        ssd1306_send_while_scrolling(ssd);
+        return;
+    }
+    ssd1306_stats_begin();
+
+    for (int page = 0; page < ssd->pages; page++) {
+        if (ssd->dirty_start[page] == ssd->dirty_end[page]) {
+            continue;
+        }
+
+        struct render_area area = {
+            .start_column = ssd->dirty_start[page],
+            .end_column = ssd->dirty_end[page] - 1,
+            .start_page = page,
+            .end_page = page
+        };
+        calculate_render_area_buffer_length(&area);
+
+        ssd1306_send_window(ssd, &area);
+    }
+    ssd1306_stats_flush(ssd);
+}
+
+// Inicia a transferência de um buffer de palavras já montado
+static void ssd1306_async_start(ssd1306_t *ssd, int idx) {
+    ssd1306_async_t *async = ssd->async;
+    i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+
+    (void)hw->clr_tx_abrt; // Libera a FIFO caso o envio anterior tenha sido abortado (NACK)
+    if (hw->tar != ssd->address) {
+        // IC_TAR só muda com o controlador desligado, e desligá-lo no meio de uma transação
+        // descarta o que ainda está na FIFO: espera a transação anterior sair inteira
+        ssd1306_i2c_wait_idle(hw);
+        hw->enable = 0;
+        hw->tar = ssd->address;
+        hw->enable = 1;
+    }
+
+    async->active = idx;
+    dma_channel_transfer_from_buffer_now(async->dma_channel, async->stream[idx], async->length[idx]);
+
+    // Quadros substituídos antes de começar não chegam ao barramento e não são contados
+    ssd1306_stats_bus(ssd, async->length[idx], 2);
+#if SSD1306_STATS
+    ssd->stats.flushes++;
+#endif
+}
+
+// Fim da transferência: inicia o buffer pendente (se houver) e avisa quem pediu o envio.
+// Nesse ponto todos os bytes já foram entregues à FIFO do I2C
+static void ssd1306_dma_irq_handler() {
+    for (int i = 0; i < NUM_I2CS; i++) {
+        ssd1306_t *ssd = async_displays[i];
+        if (ssd == NULL || !dma_channel_get_irq1_status(ssd->async->dma_channel)) {
+            continue;
+        }
+        dma_channel_acknowledge_irq1(ssd->async->dma_channel);
+
+        ssd1306_async_t *async = ssd->async;
+        int done = async->active;
+        async->active = -1;
+
+        if (async->pending != -1) {
+            int next = async->pending;
+            async->pending = -1;
+            ssd1306_async_start(ssd, next);
+        }
+
+        if (async->callback[done]) {
+            async->callback[done](async->user_data[done]);
+        }
+    }
+}
+
+// Reserva um canal de DMA ligado ao TX do I2C da instância para os envios assíncronos.
+// Apenas um display por barramento pode usar o envio assíncrono
+void ssd1306_async_init(ssd1306_t *ssd) {
+    uint index = i2c_get_index(ssd->i2c_port);
+    if (ssd->async != NULL || async_displays[index] != NULL) {
+        return;
+    }
+
+    // 0x00 + 6 comandos de endereçamento, seguidos de 0x40 + pixels
+    int stream_length = 7 + ssd->bufsize;
+
+    ssd1306_async_t *async = calloc(1, sizeof(ssd1306_async_t));
+    async->stream[0] = calloc(2 * stream_length, sizeof(uint16_t));
+    async->stream[1] = async->stream[0] + stream_length;
+    async->active = -1;
+    async->pending = -1;
+    async->dma_channel = dma_claim_unused_channel(true);
+
+    dma_channel_config config = dma_channel_get_default_config(async->dma_channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, i2c_get_dreq(ssd->i2c_port, true));
+    dma_channel_configure(async->dma_channel, &config, &i2c_get_hw(ssd->i2c_port)->data_cmd, NULL, 0, false);
+
+    // Pede dados enquanto a FIFO de TX (16 posições) tiver até 8 bytes, evitando lacunas no barramento
+    i2c_get_hw(ssd->i2c_port)->dma_tdlr = 8;
+
+    ssd->async = async;
+    async_displays[index] = ssd;
+
+    dma_channel_set_irq1_enabled(async->dma_channel, true);
+    irq_add_shared_handler(DMA_IRQ_1, ssd1306_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+}
+
+// Envia a tela inteira sem bloquear: o quadro é copiado para um dos buffers de DMA e o
+// framebuffer fica livre para o próximo desenho assim que a função retorna. Se um quadro
+// anterior ainda aguardava a vez, ele é substituído por este e o callback dele é chamado aqui
+// mesmo, antes de retornar (o conteúdo dele segue no quadro novo). callback (opcional) é
+// chamado na interrupção do DMA quando o quadro termina de ser entregue ao I2C
+void render_on_display_async(ssd1306_t *ssd, ssd1306_flush_callback_t callback, void *user_data) {
+    ssd1306_async_t *async = ssd->async;
+
+    // Sem canal de DMA reservado, ou com rolagem por hardware ativa, o envio é bloqueante
+    if (async == NULL || ssd->scroll_length) {
+        ssd1306_send_data(ssd);
+        if (callback) {
+            callback(user_data);
+        }
+        return;
+    }
+
+    uint8_t commands[] = {
+        ssd1306_control_command,
+        ssd1306_set_column_address, 0, ssd->width - 1,
+        ssd1306_set_page_address, 0, ssd->pages - 1
+    };
+
+    // Escolhe o buffer livre (ou retoma o pendente, que ainda não começou a ser enviado)
+    ssd1306_flush_callback_t superseded = NULL;
+    void *superseded_data = NULL;
+    uint32_t status = save_and_disable_interrupts();
+    int idx;
+    if (async->pending != -1) {
+        idx = async->pending;
+        async->pending = -1;
+        superseded = async->callback[idx];
+        superseded_data = async->user_data[idx];
+    } else {
+        idx = (async->active == 0) ? 1 : 0;
+    }
+    restore_interrupts(status);
+
+    if (superseded) {
+        superseded(superseded_data);
+    }
+
+    // Duas transações seguidas: comandos de endereçamento e dados, cada uma encerrada com STOP
+    uint16_t *stream = async->stream[idx];
+    int n = 0;
+    for (int i = 0; i < (int)count_of(commands); i++) {
+        stream[n++] = commands[i];
+    }
+    stream[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+    for (size_t i = 0; i < ssd->bufsize; i++) {
+        stream[n++] = ssd->ram_buffer[i];
+    }
+    stream[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+    async->length[idx] = n;
+    async->callback[idx] = callback;
+    async->user_data[idx] = user_data;
+
+    struct render_area area = {
+        .start_column = 0,
+        .end_column = ssd->width - 1,
+        .start_page = 0,
+        .end_page = ssd->pages - 1
+    };
+    ssd1306_clear_dirty(ssd, &area);
+
+    status = save_and_disable_interrupts();
+    if (async->active == -1) {
+        ssd1306_async_start(ssd, idx);
+    } else {
+        async->pending = idx;
+    }
+    restore_interrupts(status);
+}
+
+#if SSD1306_STATS
+// Copia os contadores de barramento do display
+void ssd1306_stats_get(ssd1306_t *ssd, ssd1306_stats_t *stats) {
+    uint32_t status = save_and_disable_interrupts(); // O fim de um envio por DMA também atualiza
+    *stats = ssd->stats;
+    restore_interrupts(status);
+}
+
+// Zera os contadores de barramento do display
+void ssd1306_stats_reset(ssd1306_t *ssd) {
+    uint32_t status = save_and_disable_interrupts();
+    memset(&ssd->stats, 0, sizeof(ssd->stats));
+    restore_interrupts(status);
+}
+#endif
+
+// Indica se ainda há quadro em envio assíncrono
+bool ssd1306_flush_busy(ssd1306_t *ssd) {
+    return ssd->async != NULL && (ssd->async->active != -1 || ssd->async->pending != -1);
+}
+
+// Aguarda o fim dos envios assíncronos da instância
+void ssd1306_flush_wait(ssd1306_t *ssd) {
+    if (ssd->async != NULL) {
+        ssd1306_bus_wait(ssd->i2c_port);
+    }
+}
+
+// Determina o pixel a ser aceso (no display) de acordo com a coordenada fornecida
+void ssd1306_set_pixel(ssd1306_t *ssd, int x, int y, bool set) {
+    assert(x >= 0 && x < ssd->width && y >= 0 && y < ssd->height);
+
+    const int bytes_per_row = ssd->width;
+
+    int byte_idx = 1 + (y / 8) * bytes_per_row + x;
+    uint8_t byte = ssd->ram_buffer[byte_idx];
+
+    if (set) {
+        byte |= 1 << (y % 8);
+    }
+    else {
+        byte &= ~(1 << (y % 8));
+    }
+
+    ssd->ram_buffer[byte_idx] = byte;
+    ssd1306_mark_page_dirty(ssd, y / 8, x, x);
+}
+
+// Preenche (set) ou apaga um retângulo (largura x altura) a partir de (x, y), limitado à tela.
+// Cada página coberta recebe uma máscara de bits e é alterada um byte por coluna
+void ssd1306_fill_rect(ssd1306_t *ssd, int x, int y, int width, int height, bool set) {
+    int x_1 = x + width - 1;
+    int y_1 = y + height - 1;
+
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x_1 > ssd->width - 1) x_1 = ssd->width - 1;
+    if (y_1 > ssd->height - 1) y_1 = ssd->height - 1;
+    if (x > x_1 || y > y_1) {
+        return;
+    }
+
+    for (int page = y / 8; page <= y_1 / 8; page++) {
+        // Bits da página que pertencem ao retângulo
+        int first_bit = (page == y / 8) ? y % 8 : 0;
+        int last_bit = (page == y_1 / 8) ? y_1 % 8 : 7;
+        uint8_t mask = (uint8_t)((0xFF << first_bit) & (0xFF >> (7 - last_bit)));
+
+        uint8_t *row = ssd->ram_buffer + 1 + page * ssd->width;
+        if (mask == 0xFF) {
+            memset(row + x, set ? 0xFF : 0x00, x_1 - x + 1);
+        }
+        else if (set) {
+            for (int col = x; col <= x_1; col++) {
+                row[col] |= mask;
+            }
+        }
+        else {
+            for (int col = x; col <= x_1; col++) {
+                row[col] &= ~mask;
+            }
+        }
+    }
+
+    ssd1306_mark_dirty(ssd, x, y, x_1, y_1);
+}
+
+// Apaga um retângulo de pixels (largura x altura) a partir de (x, y)
+void ssd1306_clear_rect(ssd1306_t *ssd, int x, int y, int width, int height) {
+    ssd1306_fill_rect(ssd, x, y, width, height, false);
+}
+
+// Linha horizontal de `width` pixels a partir de (x, y): um byte por coluna
+void ssd1306_hline(ssd1306_t *ssd, int x, int y, int width, bool set) {
+    ssd1306_fill_rect(ssd, x, y, width, 1, set);
+}
+
+// Linha vertical de `height` pixels a partir de (x, y): um byte por página
+void ssd1306_vline(ssd1306_t *ssd, int x, int y, int height, bool set) {
+    ssd1306_fill_rect(ssd, x, y, 1, height, set);
+}
+
+// Contorno de um retângulo (largura x altura) a partir de (x, y)
+void ssd1306_rect(ssd1306_t *ssd, int x, int y, int width, int height, bool set) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    ssd1306_hline(ssd, x, y, width, set);
+    ssd1306_hline(ssd, x, y + height - 1, width, set);
+    ssd1306_vline(ssd, x, y, height, set);
+    ssd1306_vline(ssd, x + width - 1, y, height, set);
+}
+
+// Algoritmo de Bresenham básico; linhas horizontais e verticais usam as rotinas por byte
+void ssd1306_draw_line(ssd1306_t *ssd, int x_0, int y_0, int x_1, int y_1, bool set) {
+    if (y_0 == y_1) {
+        ssd1306_hline(ssd, x_0 < x_1 ? x_0 : x_1, y_0, abs(x_1 - x_0) + 1, set);
+        return;
+    }
+    if (x_0 == x_1) {
+        ssd1306_vline(ssd, x_0, y_0 < y_1 ? y_0 : y_1, abs(y_1 - y_0) + 1, set);
+        return;
+    }
+
+    int dx = abs(x_1 - x_0); // Deslocamentos
+    int dy = -abs(y_1 - y_0);
+    int sx = x_0 < x_1 ? 1 : -1; // Direção de avanço
+    int sy = y_0 < y_1 ? 1 : -1;
+    int error = dx + dy; // Erro acumulado
+    int error_2;
+
+    while (true) {
+        ssd1306_set_pixel(ssd, x_0, y_0, set); // Acende pixel no ponto atual
+        if (x_0 == x_1 && y_0 == y_1) {
+            break; // Verifica se o ponto final foi alcançado
+        }
+
+        error_2 = 2 * error; // Ajusta o erro acumulado
+
+        if (error_2 >= dy) {
+            error += dy;
+            x_0 += sx; // Avança na direção x
+        }
+        if (error_2 <= dx) {
+            error += dx;
+            y_0 += sy; // Avança na direção y
+        }
+    }
+}
+
+// Adquire os pixels para um caractere Latin-1 (de acordo com ssd1306_font.h): uma única leitura
+static inline const uint8_t *ssd1306_get_glyph(uint8_t character) {
+    return &font[font_index[character] * 8];
+}
+
+// Lê o próximo caractere de uma string UTF-8 e avança o ponteiro. Pontos de código fora do
+// Latin-1 viram espaço; bytes que não formam uma sequência válida são tratados como Latin-1
+uint8_t ssd1306_next_char(const char **string) {
+    const uint8_t *s = (const uint8_t *)*string;
+    uint8_t lead = s[0];
+
+    if (lead < 0x80) {
+        *string += 1;
+        return lead;
+    }
+
+    int length = (lead & 0xE0) == 0xC0 ? 2 : (lead & 0xF0) == 0xE0 ? 3 : (lead & 0xF8) == 0xF0 ? 4 : 0;
+    uint32_t code = lead & (0x7F >> length);
+    for (int i = 1; i < length; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+            length = 0; // Sequência interrompida (inclui o terminador)
+            break;
+        }
+        code = (code << 6) | (s[i] & 0x3F);
+    }
+
+    if (length == 0) {
+        *string += 1;
+        return lead;
+    }
+    *string += length;
+    return code < 0x100 ? code : ' ';
+}
+
+// Escreve uma coluna de `rows` bits (bit 0 no topo) na coluna x a partir da linha y, em qualquer
+// altura: a palavra é deslocada de y % 8 e dividida entre as páginas que ela cobre, uma operação
+// de byte por página. opaque substitui os pixels cobertos; caso contrário os bits são somados (OR)
+static inline void ssd1306_blit_column(ssd1306_t *ssd, int x, int y, uint32_t bits, int rows, bool opaque) {
+    if (x < 0 || x >= ssd->width) {
+        return;
+    }
+
+    uint32_t mask = rows >= 32 ? 0xFFFFFFFFu : (1u << rows) - 1;
+    int shift = y & 7;
+    int page = y >> 3;
+    int last_page = (y + rows - 1) >> 3;
+
+    for (int k = 0; page <= last_page; k++, page++) {
+        if (page < 0 || page >= ssd->pages) {
+            continue;
+        }
+        // O ponteiro só é formado para páginas dentro do buffer
+        uint8_t *dst = ssd->ram_buffer + 1 + page * ssd->width + x;
+
+        // Parte da palavra que cai na página k (k = 0 recebe os bits deslocados para cima)
+        uint8_t page_bits = k == 0 ? bits << shift : bits >> (8 * k - shift);
+        uint8_t page_mask = k == 0 ? mask << shift : mask >> (8 * k - shift);
+        if (opaque) {
+            *dst = (*dst & ~page_mask) | (page_bits & page_mask);
+        }
+        else {
+            *dst |= page_bits & page_mask;
+        }
+    }
+}
+
+// Desenha um único caractere no display, em qualquer linha y (o fundo do glifo é apagado)
+void ssd1306_draw_char(ssd1306_t *ssd, int16_t x, int16_t y, uint8_t character) {
+    if (x > ssd->width - 8 || y > ssd->height - 8) {
+        return;
+    }
+
+    const uint8_t *glyph = ssd1306_get_glyph(character);
+
+    if ((y & 7) == 0 && x >= 0 && y >= 0) {
+        // Alinhado à página: cópia direta das 8 colunas
+        memcpy(ssd->ram_buffer + 1 + (y / 8) * ssd->width + x, glyph, 8);
+    }
+    else {
+        for (int i = 0; i < 8; i++) {
+            ssd1306_blit_column(ssd, x + i, y, glyph[i], 8, true);
+        }
+    }
+    ssd1306_mark_dirty(ssd, x, y, x + 7, y + 7);
+}
+
+// Desenha apenas a coluna `column` (0 a 7) de um caractere em (x, y), apagando o fundo dela.
+// Usada para textos deslocados coluna a coluna (ex.: letreiros)
+void ssd1306_draw_char_column(ssd1306_t *ssd, int x, int y, uint8_t character, int column) {
+    if (x < 0 || x >= ssd->width) {
+        return;
+    }
+
+    ssd1306_blit_column(ssd, x, y, ssd1306_get_glyph(character)[column & 7], 8, true);
+    ssd1306_mark_dirty(ssd, x, y, x, y + 7);
+}
+
+// Desenha uma string UTF-8, chamando a função de desenhar caractere várias vezes
+void ssd1306_draw_string(ssd1306_t *ssd, int16_t x, int16_t y, const char *string) {
+    if (x > ssd->width - 8 || y > ssd->height - 8) {
+        return;
+    }
+
+    while (*string) {
+        ssd1306_draw_char(ssd, x, y, ssd1306_next_char(&string));
+        x += 8;
+    }
+}
+
+// Desenha o bitmap (a ser fornecido em display_oled.c) no display: uma cópia e um único envio.
+// O bitmap segue o formato de ram_buffer (página a página, width bytes por página)
+void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap) {
+    memcpy(ssd->ram_buffer + 1, bitmap, ssd->bufsize - 1);
+    ssd1306_send_data(ssd);
+}
+
+// Copia um bitmap (largura x altura) para o framebuffer na posição (x, y), sem enviar ao display.
+// O bitmap é organizado como ram_buffer: (altura + 7) / 8 páginas de `largura` bytes, bit 0 no
+// topo. y não precisa ser múltiplo de 8: cada byte é deslocado e dividido entre duas páginas com
+// máscaras. Pixels fora da tela são descartados
+void ssd1306_blit_bitmap(ssd1306_t *ssd, const uint8_t *bitmap, int x, int y, int width, int height) {
+    int src_pages = (height + 7) / 8;
+    int shift = y & 7;
+    int first_page = y >> 3; // Divisão arredondada para baixo, inclusive para y negativo
+
+    int col_0 = x < 0 ? 0 : x;
+    int col_1 = x + width - 1 < ssd->width - 1 ? x + width - 1 : ssd->width - 1;
+    if (col_0 > col_1) {
+        return;
+    }
+
+    for (int sp = 0; sp < src_pages; sp++) {
+        int rows = height - sp * 8 < 8 ? height - sp * 8 : 8;
+        uint16_t mask = (uint16_t)((1u << rows) - 1) << shift;
+        const uint8_t *src = bitmap + sp * width;
+
+        for (int part = 0; part < (shift ? 2 : 1); part++) {
+            int page = first_page + sp + part;
+            if (page < 0 || page >= ssd->pages) {
+                continue;
+            }
+
+            uint8_t page_mask = mask >> (8 * part);
+            uint8_t *dst = ssd->ram_buffer + 1 + page * ssd->width;
+            for (int col = col_0; col <= col_1; col++) {
+                uint8_t bits = (uint16_t)(src[col - x] << shift) >> (8 * part);
+                dst[col] = (dst[col] & ~page_mask) | (bits & page_mask);
+            }
+        }
+    }
+
+    ssd1306_mark_dirty(ssd, col_0, y, col_1, y + height - 1);
+}
+
+// Desenha um bitmap em qualquer posição e envia ao display apenas as janelas afetadas
+void ssd1306_draw_bitmap_area(ssd1306_t *ssd, const uint8_t *bitmap, int x, int y, int width, int height) {
+    ssd1306_blit_bitmap(ssd, bitmap, x, y, width, height);
+    render_dirty_on_display(ssd);
+}
+
+// Expansão de um nibble de coluna: cada bit vira `s` bits consecutivos
+#define ssd1306_scale_bits(s) ((1u << (s)) - 1)
+#define ssd1306_scale_nibble(n, s) \
+    ((((n) & 1) ? ssd1306_scale_bits(s) : 0) | \
+     (((n) & 2) ? ssd1306_scale_bits(s) << (s) : 0) | \
+     (((n) & 4) ? ssd1306_scale_bits(s) << (2 * (s)) : 0) | \
+     (((n) & 8) ? ssd1306_scale_bits(s) << (3 * (s)) : 0))
+#define ssd1306_scale_row(s) { \
+    ssd1306_scale_nibble(0, s), ssd1306_scale_nibble(1, s), ssd1306_scale_nibble(2, s), ssd1306_scale_nibble(3, s), \
+    ssd1306_scale_nibble(4, s), ssd1306_scale_nibble(5, s), ssd1306_scale_nibble(6, s), ssd1306_scale_nibble(7, s), \
+    ssd1306_scale_nibble(8, s), ssd1306_scale_nibble(9, s), ssd1306_scale_nibble(10, s), ssd1306_scale_nibble(11, s), \
+    ssd1306_scale_nibble(12, s), ssd1306_scale_nibble(13, s), ssd1306_scale_nibble(14, s), ssd1306_scale_nibble(15, s) }
+
+// Tabelas de ampliação vertical para as escalas 1 a 8 (4 * 8 = 32 bits no máximo por nibble)
+static const uint32_t scale_table[ssd1306_max_scale][16] = {
+    ssd1306_scale_row(1), ssd1306_scale_row(2), ssd1306_scale_row(3), ssd1306_scale_row(4),
+    ssd1306_scale_row(5), ssd1306_scale_row(6), ssd1306_scale_row(7), ssd1306_scale_row(8),
+};
+
+// Desenha um caractere ampliado `scale` vezes, somando (OR) os pixels acesos ao que já existe.
+// Cada coluna da fonte é expandida pela tabela e escrita `scale` vezes lado a lado
+void ssd1306_draw_char_scaled(ssd1306_t *ssd, int16_t x, int16_t y, uint8_t character, int scale) {
+    if (scale < 1 || scale > ssd1306_max_scale)
+        return;
+    if (x > ssd->width - 8 * scale || y > ssd->height - 8 * scale)
+        return;
+
+    const uint8_t *glyph = ssd1306_get_glyph(character);
+    const uint32_t *table = scale_table[scale - 1];
+    int half = 4 * scale; // Altura de um nibble ampliado
+
+    for (int col = 0; col < 8; col++) {
+        uint8_t col_data = glyph[col];
+        if (!col_data) {
+            continue;
+        }
+
+        uint32_t low = table[col_data & 0x0F];
+        uint32_t high = table[col_data >> 4];
+        for (int dx = 0; dx < scale; dx++) {
+            int cx = x + col * scale + dx;
+            if (scale <= 4) {
+                // A coluna inteira cabe em uma palavra de 32 bits
+                ssd1306_blit_column(ssd, cx, y, low | (high << half), 2 * half, false);
+            }
+            else {
+                ssd1306_blit_column(ssd, cx, y, low, half, false);
+                ssd1306_blit_column(ssd, cx, y + half, high, half, false);
+            }
+        }
+    }
+    ssd1306_mark_dirty(ssd, x, y, x + 8 * scale - 1, y + 8 * scale - 1);
+}
+
+void ssd1306_draw_string_scaled(ssd1306_t *ssd, int16_t x, int16_t y, const char *string, int scale) {
+    while (*string) {
+        ssd1306_draw_char_scaled(ssd, x, y, ssd1306_next_char(&string), scale);
+        x += 8 * scale;  // Avança a posição com base no tamanho ampliado
+    }
+}
+
+// Largura, em pixels, de uma string UTF-8 desenhada com uma fonte gerada (ssd1306_fonts.h)
+int ssd1306_text_width(const ssd1306_font_t *font, const char *string) {
+    int width = 0;
+    while (*string) {
+        width += font->glyphs[font->index[ssd1306_next_char(&string)]].width;
+    }
+    return width;
+}
+
+// Desenha uma string UTF-8 com uma fonte gerada, com o topo da célula na linha y (qualquer valor).
+// Cada glifo é copiado da flash em bytes por ssd1306_blit_bitmap, já com o fundo e o espaçamento
+// apagados, então redesenhar um valor por cima do anterior não deixa resíduos. Retorna a coluna
+// logo depois do último glifo
+int ssd1306_draw_text(ssd1306_t *ssd, const ssd1306_font_t *font, int x, int y, const char *string) {
+    while (*string) {
+        const ssd1306_glyph_t *glyph = &font->glyphs[font->index[ssd1306_next_char(&string)]];
+        ssd1306_blit_bitmap(ssd, font->bitmap + glyph->offset, x, y, glyph->width, font->height);
+        x += glyph->width;
+    }
+    return x;
+}
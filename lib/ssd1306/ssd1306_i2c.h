@@ -0,0 +1,134 @@
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+
+#ifndef ssd1306_inc_h
+#define ssd1306_inc_h
+
+#define ssd1306_height 64 // Define a altura padrão do display (64 pixels)
+#define ssd1306_width 128 // Define a largura padrão do display (128 pixels)
+#define ssd1306_max_pages 8 // Maior número de páginas suportado por instância (128x64)
+
+#define ssd1306_i2c_address _u(0x3C) // Define o endereço do i2c do display
+
+#define ssd1306_i2c_clock 400 // Define o tempo do clock (pode ser aumentado)
+
+// Comandos de configuração (endereços)
+#define ssd1306_set_memory_mode _u(0x20)
+#define ssd1306_set_column_address _u(0x21)
+#define ssd1306_set_page_address _u(0x22)
+#define ssd1306_set_horizontal_scroll _u(0x26) // | 0x01 rola para a esquerda
+#define ssd1306_set_vertical_horizontal_scroll _u(0x29) // | 0x03 (0x2A) rola para a esquerda
+#define ssd1306_set_scroll _u(0x2E)
+
+#define ssd1306_set_display_start_line _u(0x40)
+
+#define ssd1306_set_contrast _u(0x81)
+#define ssd1306_set_charge_pump _u(0x8D)
+
+#define ssd1306_set_segment_remap _u(0xA0)
+#define ssd1306_set_entire_on _u(0xA4)
+#define ssd1306_set_all_on _u(0xA5)
+#define ssd1306_set_normal_display _u(0xA6)
+#define ssd1306_set_inverse_display _u(0xA7)
+#define ssd1306_set_vertical_scroll_area _u(0xA3)
+#define ssd1306_set_mux_ratio _u(0xA8)
+#define ssd1306_set_display _u(0xAE)
+#define ssd1306_set_common_output_direction _u(0xC0)
+#define ssd1306_set_common_output_direction_flip _u(0xC0)
+
+#define ssd1306_set_display_offset _u(0xD3)
+#define ssd1306_set_display_clock_divide_ratio _u(0xD5)
+#define ssd1306_set_precharge _u(0xD9)
+#define ssd1306_set_common_pin_configuration _u(0xDA)
+#define ssd1306_set_vcomh_deselect_level _u(0xDB)
+
+// Intervalo entre passos da rolagem por hardware, em quadros do display
+#define ssd1306_scroll_frames_2 _u(0x07)
+#define ssd1306_scroll_frames_3 _u(0x04)
+#define ssd1306_scroll_frames_4 _u(0x05)
+#define ssd1306_scroll_frames_5 _u(0x00)
+#define ssd1306_scroll_frames_25 _u(0x06)
+#define ssd1306_scroll_frames_64 _u(0x01)
+#define ssd1306_scroll_frames_128 _u(0x02)
+#define ssd1306_scroll_frames_256 _u(0x03)
+#define ssd1306_scroll_commands_max 12
+
+#define ssd1306_page_height _u(8)
+#define ssd1306_n_pages (ssd1306_height / ssd1306_page_height)
+#define ssd1306_buffer_length (ssd1306_n_pages * ssd1306_width)
+
+#define ssd1306_control_command _u(0x00)
+#define ssd1306_control_data _u(0x40)
+
+#define ssd1306_command_stream_max 32 // Comandos enviados por transação I2C
+#define ssd1306_max_scale 8 // Maior ampliação aceita por ssd1306_draw_char_scaled
+
+#define ssd1306_write_mode _u(0xFE)
+#define ssd1306_read_mode _u(0xFF)
+
+struct render_area {
+    uint8_t start_column;
+    uint8_t end_column;
+    uint8_t start_page;
+    uint8_t end_page;
+
+    int buffer_length;
+};
+
+// Chamada (em contexto de interrupção) quando um envio assíncrono termina, ou por
+// render_on_display_async quando o quadro é substituído antes de começar
+typedef void (*ssd1306_flush_callback_t)(void *user_data);
+
+// Estado do envio assíncrono por DMA: dois buffers de palavras no formato do registrador
+// IC_DATA_CMD (byte nos bits 0-7, STOP no bit 9), um em transmissão e outro aguardando a vez
+typedef struct {
+  uint16_t *stream[2];
+  int length[2];
+  ssd1306_flush_callback_t callback[2];
+  void *user_data[2];
+  volatile int active;  // Buffer sendo transferido pelo DMA (-1 se nenhum)
+  volatile int pending; // Buffer pronto, iniciado ao fim do atual (-1 se nenhum)
+  int dma_channel;
+} ssd1306_async_t;
+
+// Estatísticas de uso do barramento, ativadas com -DSSD1306_STATS=1 (opção SSD1306_STATS no CMake)
+#ifndef SSD1306_STATS
+#define SSD1306_STATS 0
+#endif
+
+typedef struct {
+  uint32_t transactions; // Transações I2C (START ... STOP) enviadas ao display
+  uint32_t bytes;        // Bytes transmitidos, incluindo os bytes de controle (sem o endereço)
+  uint32_t flushes;      // Envios de quadro (tela inteira, janelas alteradas ou DMA)
+  uint32_t flush_us;     // Tempo gasto nos envios bloqueantes, em microssegundos
+} ssd1306_stats_t;
+
+// Instância de um display: barramento, endereço, geometria e framebuffer. ram_buffer guarda
+// o byte de controle 0x40 na posição 0, seguido dos pixels página a página (width bytes por
+// página), de modo que a tela ou uma janela dela é enviada direto do buffer de desenho
+typedef struct {
+  uint8_t width, height, pages, address;
+  i2c_inst_t * i2c_port;
+  bool external_vcc;
+  uint8_t *ram_buffer;
+  size_t bufsize;
+  uint8_t port_buffer[2];
+
+  // Faixa de colunas alterada em cada página desde o último envio
+  // (fim exclusivo; início igual ao fim indica página sem alterações)
+  uint8_t dirty_start[ssd1306_max_pages];
+  uint8_t dirty_end[ssd1306_max_pages];
+
+  ssd1306_async_t *async;
+
+  // Comandos que (re)iniciam a rolagem por hardware ativa (scroll_length = 0: sem rolagem)
+  uint8_t scroll_commands[ssd1306_scroll_commands_max];
+  uint8_t scroll_length;
+
+#if SSD1306_STATS
+  ssd1306_stats_t stats;
+#endif
+} ssd1306_t;
+
+#endif
\ No newline at end of file
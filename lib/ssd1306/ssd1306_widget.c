@@ -0,0 +1,372 @@
+#include <stdio.h>
+#include <string.h>
+#include "ssd1306_widget.h"
+
+// Número de caracteres de uma string UTF-8 (bytes de continuação não contam)
+static int ssd1306_text_length(const char *text) {
+    int length = 0;
+    for (; *text; text++) {
+        if (((uint8_t)*text & 0xC0) != 0x80) {
+            length++;
+        }
+    }
+    return length;
+}
+
+// Rótulo estático: desenhado uma única vez (somado ao que já existe, sem apagar a área)
+void ssd1306_label_init(ssd1306_widget_t *widget, int x, int y, const char *text, int scale) {
+    memset(widget, 0, sizeof(*widget));
+    widget->x = x;
+    widget->y = y;
+    widget->scale = scale;
+    widget->text = text;
+    widget->width = ssd1306_text_length(text) * 8 * scale;
+    widget->height = 8 * scale;
+}
+
+// Valor numérico em ponto fixo (value / 10^decimals) seguido de um sufixo opcional
+void ssd1306_value_init(ssd1306_widget_t *widget, int x, int y, int width, int decimals, const char *suffix, int scale) {
+    memset(widget, 0, sizeof(*widget));
+    widget->x = x;
+    widget->y = y;
+    widget->width = width;
+    widget->height = 8 * scale;
+    widget->scale = scale;
+    widget->decimals = decimals;
+    widget->text = suffix;
+}
+
+// Valor numérico desenhado com uma fonte gerada (ex.: &ssd1306_font_num16); a altura é a da fonte
+void ssd1306_value_init_font(ssd1306_widget_t *widget, int x, int y, int width, int decimals, const char *suffix, const ssd1306_font_t *font) {
+    ssd1306_value_init(widget, x, y, width, decimals, suffix, 1);
+    widget->height = font->height;
+    widget->font = font;
+}
+
+// Indicador com legenda seguida de uma seta (9 x 9 pixels) na direção informada
+void ssd1306_arrow_init(ssd1306_widget_t *widget, int x, int y, int width) {
+    memset(widget, 0, sizeof(*widget));
+    widget->x = x;
+    widget->y = y;
+    widget->width = width;
+    widget->height = 10;
+    widget->scale = 1;
+}
+
+// Barra horizontal com contorno; o interior é preenchido proporcionalmente a value / max
+void ssd1306_bar_init(ssd1306_widget_t *widget, int x, int y, int width, int height, int32_t max) {
+    memset(widget, 0, sizeof(*widget));
+    widget->x = x;
+    widget->y = y;
+    widget->width = width;
+    widget->height = height;
+    widget->max = max > 0 ? max : 1;
+}
+
+// Letreiro de uma linha (8 pixels de altura): um texto que cabe na largura é desenhado uma
+// única vez; um texto mais largo é deslocado por ssd1306_marquee_step, coluna a coluna
+void ssd1306_marquee_init(ssd1306_widget_t *widget, int x, int y, int width) {
+    memset(widget, 0, sizeof(*widget));
+    widget->x = x;
+    widget->y = y;
+    widget->width = width;
+    widget->height = 8;
+    widget->scale = 1;
+}
+
+// Força o redesenho do widget na próxima atualização (ex.: depois de ssd1306_clear)
+void ssd1306_widget_invalidate(ssd1306_widget_t *widget) {
+    widget->valid = false;
+}
+
+// Desenha o rótulo se ainda não estiver na tela. Retorna true se desenhou
+bool ssd1306_label_draw(ssd1306_t *ssd, ssd1306_widget_t *widget) {
+    if (widget->valid) {
+        return false;
+    }
+
+    ssd1306_draw_string_scaled(ssd, widget->x, widget->y, widget->text, widget->scale);
+    widget->valid = true;
+    return true;
+}
+
+// Atualiza o valor numérico; só apaga e redesenha a área se o valor mudou. Retorna true se redesenhou
+bool ssd1306_value_set(ssd1306_t *ssd, ssd1306_widget_t *widget, int32_t value) {
+    if (widget->valid && widget->value == value) {
+        return false;
+    }
+
+    static const uint32_t powers[] = {1, 10, 100, 1000, 10000, 100000};
+    uint32_t divisor = powers[widget->decimals < count_of(powers) ? widget->decimals : count_of(powers) - 1];
+    uint32_t magnitude = value < 0 ? -(uint32_t)value : (uint32_t)value;
+    const char *suffix = widget->text ? widget->text : "";
+
+    char text[ssd1306_widget_text_max];
+    if (divisor > 1) {
+        snprintf(text, sizeof(text), "%s%lu.%0*lu%s", value < 0 ? "-" : "",
+                 (unsigned long)(magnitude / divisor), widget->decimals,
+                 (unsigned long)(magnitude % divisor), suffix);
+    }
+    else {
+        snprintf(text, sizeof(text), "%ld%s", (long)value, suffix);
+    }
+
+    if (widget->font) {
+        // Os glifos já apagam o próprio fundo: só a sobra à direita do texto precisa ser limpa
+        int end = ssd1306_draw_text(ssd, widget->font, widget->x, widget->y, text);
+        ssd1306_clear_rect(ssd, end, widget->y, widget->x + widget->width - end, widget->height);
+    }
+    else {
+        ssd1306_clear_rect(ssd, widget->x, widget->y, widget->width, widget->height);
+        ssd1306_draw_string_scaled(ssd, widget->x, widget->y, text, widget->scale);
+    }
+    widget->value = value;
+    widget->valid = true;
+    return true;
+}
+
+// Desenha uma seta 9 x 9 com canto superior esquerdo em (x, y)
+static void ssd1306_draw_arrow(ssd1306_t *ssd, int x, int y, ssd1306_arrow_t direction) {
+    int cx = x + 4;
+    int cy = y + 4;
+
+    switch (direction) {
+    case ssd1306_arrow_up:
+        ssd1306_vline(ssd, cx, y, 9, true);
+        ssd1306_draw_line(ssd, cx, y, cx - 3, y + 3, true);
+        ssd1306_draw_line(ssd, cx, y, cx + 3, y + 3, true);
+        break;
+    case ssd1306_arrow_down:
+        ssd1306_vline(ssd, cx, y, 9, true);
+        ssd1306_draw_line(ssd, cx, y + 8, cx - 3, y + 5, true);
+        ssd1306_draw_line(ssd, cx, y + 8, cx + 3, y + 5, true);
+        break;
+    case ssd1306_arrow_left:
+        ssd1306_hline(ssd, x, cy, 9, true);
+        ssd1306_draw_line(ssd, x, cy, x + 3, cy - 3, true);
+        ssd1306_draw_line(ssd, x, cy, x + 3, cy + 3, true);
+        break;
+    case ssd1306_arrow_right:
+        ssd1306_hline(ssd, x, cy, 9, true);
+        ssd1306_draw_line(ssd, x + 8, cy, x + 5, cy - 3, true);
+        ssd1306_draw_line(ssd, x + 8, cy, x + 5, cy + 3, true);
+        break;
+    // Diagonais: a haste vai de canto a canto e a ponta é um canto de 5 pixels
+    case ssd1306_arrow_up_left:
+        ssd1306_draw_line(ssd, x + 8, y + 8, x, y, true);
+        ssd1306_hline(ssd, x, y, 5, true);
+        ssd1306_vline(ssd, x, y, 5, true);
+        break;
+    case ssd1306_arrow_up_right:
+        ssd1306_draw_line(ssd, x, y + 8, x + 8, y, true);
+        ssd1306_hline(ssd, x + 4, y, 5, true);
+        ssd1306_vline(ssd, x + 8, y, 5, true);
+        break;
+    case ssd1306_arrow_down_left:
+        ssd1306_draw_line(ssd, x + 8, y, x, y + 8, true);
+        ssd1306_hline(ssd, x, y + 8, 5, true);
+        ssd1306_vline(ssd, x, y + 4, 5, true);
+        break;
+    case ssd1306_arrow_down_right:
+        ssd1306_draw_line(ssd, x, y, x + 8, y + 8, true);
+        ssd1306_hline(ssd, x + 4, y + 8, 5, true);
+        ssd1306_vline(ssd, x + 8, y + 4, 5, true);
+        break;
+    default:
+        break;
+    }
+}
+
+// Atualiza legenda e direção do indicador; só redesenha se algum dos dois mudou
+bool ssd1306_arrow_set(ssd1306_t *ssd, ssd1306_widget_t *widget, const char *caption, ssd1306_arrow_t direction) {
+    if (!caption) {
+        caption = "";
+    }
+    if (widget->valid && widget->value == (int32_t)direction && strcmp(widget->shown, caption) == 0) {
+        return false;
+    }
+
+    snprintf(widget->shown, sizeof(widget->shown), "%s", caption);
+    widget->value = direction;
+    widget->valid = true;
+
+    ssd1306_clear_rect(ssd, widget->x, widget->y, widget->width, widget->height);
+    ssd1306_draw_string_scaled(ssd, widget->x, widget->y + 1, widget->shown, 1);
+
+    // A seta fica logo depois da legenda, centralizada na linha do texto
+    int arrow_x = widget->x + ssd1306_text_length(widget->shown) * 8 + 6;
+    if (arrow_x + 9 <= widget->x + widget->width) {
+        ssd1306_draw_arrow(ssd, arrow_x, widget->y, direction);
+    }
+    return true;
+}
+
+// Atualiza o nível da barra; redesenha apenas o interior, e só se a largura preenchida mudou
+bool ssd1306_bar_set(ssd1306_t *ssd, ssd1306_widget_t *widget, int32_t value) {
+    if (value < 0) value = 0;
+    if (value > widget->max) value = widget->max;
+
+    int inner = widget->width - 4;
+    int filled = (int)((int64_t)value * inner / widget->max);
+    int shown = (int)((int64_t)widget->value * inner / widget->max);
+
+    if (widget->valid && filled == shown) {
+        widget->value = value;
+        return false;
+    }
+
+    if (!widget->valid) {
+        ssd1306_clear_rect(ssd, widget->x, widget->y, widget->width, widget->height);
+        ssd1306_rect(ssd, widget->x, widget->y, widget->width, widget->height, true);
+        shown = 0;
+    }
+
+    // Só a faixa entre o nível antigo e o novo muda
+    if (filled > shown) {
+        ssd1306_fill_rect(ssd, widget->x + 2 + shown, widget->y + 2, filled - shown, widget->height - 4, true);
+    }
+    else {
+        ssd1306_fill_rect(ssd, widget->x + 2 + filled, widget->y + 2, shown - filled, widget->height - 4, false);
+    }
+
+    widget->value = value;
+    widget->valid = true;
+    return true;
+}
+
+// Redesenha a faixa do letreiro a partir do deslocamento atual (widget->value, em pixels).
+// Cada coluna da faixa recebe uma coluna de glifo, então o custo não depende do tamanho do texto
+static void ssd1306_marquee_render(ssd1306_t *ssd, ssd1306_widget_t *widget) {
+    int text_width = widget->max;
+    int period = text_width + ssd1306_marquee_gap;
+
+    for (int col = 0; col < widget->width; col++) {
+        int p = widget->value + col;
+        if (text_width > widget->width) {
+            p %= period;
+        }
+
+        if (p < text_width) {
+            ssd1306_draw_char_column(ssd, widget->x + col, widget->y, (uint8_t)widget->shown[p / 8], p % 8);
+        }
+        else {
+            ssd1306_draw_char_column(ssd, widget->x + col, widget->y, ' ', 0);
+        }
+    }
+}
+
+// Troca o texto do letreiro (UTF-8) e o desenha a partir do início; não faz nada se o texto
+// já é o exibido. Retorna true se redesenhou
+bool ssd1306_marquee_set(ssd1306_t *ssd, ssd1306_widget_t *widget, const char *text) {
+    char latin1[ssd1306_widget_text_max];
+    int length = 0;
+
+    while (*text && length < (int)sizeof(latin1) - 1) {
+        latin1[length++] = (char)ssd1306_next_char(&text);
+    }
+    latin1[length] = '\0';
+
+    if (widget->valid && strcmp(widget->shown, latin1) == 0) {
+        return false;
+    }
+
+    memcpy(widget->shown, latin1, length + 1);
+    widget->max = length * 8;
+    widget->value = 0;
+    widget->valid = true;
+    ssd1306_marquee_render(ssd, widget);
+    return true;
+}
+
+// Avança o letreiro `pixels` colunas, se o texto não couber na largura. Retorna true se deslocou
+bool ssd1306_marquee_step(ssd1306_t *ssd, ssd1306_widget_t *widget, int pixels) {
+    if (!ssd1306_marquee_scrolling(widget)) {
+        return false;
+    }
+
+    widget->value = (widget->value + pixels) % (widget->max + ssd1306_marquee_gap);
+    ssd1306_marquee_render(ssd, widget);
+    return true;
+}
+
+// Indica se o letreiro está na tela com um texto mais largo que a sua faixa
+bool ssd1306_marquee_scrolling(const ssd1306_widget_t *widget) {
+    return widget->valid && widget->max > widget->width;
+}
+
+// Indica se o letreiro pode rolar por hardware: linha alinhada a uma página e texto que cabe
+// nas colunas da GDDRAM (o controlador gira a página inteira, com retorno nas 128 colunas)
+static bool ssd1306_marquee_fits_hardware(const ssd1306_t *ssd, const ssd1306_widget_t *widget) {
+    return !(widget->y & 7) && widget->max <= ssd->width;
+}
+
+// Desenha o texto do letreiro na página inteira a partir da coluna 0, como o hardware vai girá-lo
+static void ssd1306_marquee_render_row(ssd1306_t *ssd, ssd1306_widget_t *widget) {
+    ssd1306_widget_t row = *widget;
+    row.x = 0;
+    row.width = ssd->width;
+    row.value = 0;
+    ssd1306_marquee_render(ssd, &row);
+    widget->valid = false; // Os passos por software deixam de valer para esta linha
+}
+
+// Passa o letreiro para a rolagem por hardware, para quando não haverá quem chame
+// ssd1306_marquee_step (ex.: tela de erro final). Só é possível se a linha estiver alinhada a
+// uma página e o texto couber nas colunas da GDDRAM: a página inteira recebe o texto a partir da
+// coluna 0 e o controlador passa a girá-la sozinho, sem tráfego I2C. ssd1306_stop_scroll encerra
+bool ssd1306_marquee_hardware(ssd1306_t *ssd, ssd1306_widget_t *widget, uint8_t interval) {
+    if (!ssd1306_marquee_scrolling(widget) || !ssd1306_marquee_fits_hardware(ssd, widget)) {
+        return false;
+    }
+
+    ssd1306_marquee_render_row(ssd, widget);
+    render_dirty_on_display(ssd);
+    ssd1306_start_scroll(ssd, widget->y / 8, widget->y / 8, true, interval, 0);
+    return true;
+}
+
+// Passa para a rolagem por hardware todas as linhas de uma tela de status que não cabem, se der:
+// cada uma precisa caber na GDDRAM (ssd1306_marquee_hardware) e o controlador gira um único bloco
+// de páginas, então entre a primeira e a última só pode haver páginas dessas linhas ou vazias.
+// Assim a tela rola sem nenhum envio por passo. Retorna false sem alterar nada se alguma linha
+// só rola por software (ssd1306_marquee_step), ou se nenhuma precisa rolar
+bool ssd1306_marquee_hardware_lines(ssd1306_t *ssd, ssd1306_widget_t *lines, int count, uint8_t interval) {
+    uint32_t scrolling_pages = 0;
+    int start_page = ssd->pages, end_page = -1;
+    for (int i = 0; i < count; i++) {
+        if (!ssd1306_marquee_scrolling(&lines[i])) {
+            continue;
+        }
+        if (!ssd1306_marquee_fits_hardware(ssd, &lines[i])) {
+            return false;
+        }
+        int page = lines[i].y / 8;
+        scrolling_pages |= 1u << page;
+        start_page = page < start_page ? page : start_page;
+        end_page = page > end_page ? page : end_page;
+    }
+    if (!scrolling_pages) {
+        return false;
+    }
+
+    for (int page = start_page; page <= end_page; page++) {
+        if (scrolling_pages & (1u << page)) {
+            continue;
+        }
+        const uint8_t *row = ssd->ram_buffer + 1 + page * ssd->width;
+        for (int x = 0; x < ssd->width; x++) {
+            if (row[x]) {
+                return false; // Página com conteúdo fixo no meio do bloco: ela rolaria junto
+            }
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (ssd1306_marquee_scrolling(&lines[i])) {
+            ssd1306_marquee_render_row(ssd, &lines[i]);
+        }
+    }
+    render_dirty_on_display(ssd);
+    ssd1306_start_scroll(ssd, start_page, end_page, true, interval, 0);
+    return true;
+}
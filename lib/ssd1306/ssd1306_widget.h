@@ -0,0 +1,56 @@
+#ifndef ssd1306_widget_h
+#define ssd1306_widget_h
+
+#include "ssd1306.h"
+
+// Widgets de tela em modo retido: cada widget guarda o que está desenhado na sua área e só
+// redesenha (e marca como alterada) essa área quando o valor associado muda. Depois de atualizar
+// os widgets, basta chamar render_dirty_on_display(), que não envia nada se nada mudou.
+
+#define ssd1306_widget_text_max 40 // Maior texto exibido por um widget (bytes, com o terminador)
+#define ssd1306_marquee_gap 16 // Espaço (pixels) entre o fim do texto do letreiro e o seu reinício
+
+// Direção desenhada pelo indicador de seta
+typedef enum {
+    ssd1306_arrow_none,
+    ssd1306_arrow_up,
+    ssd1306_arrow_down,
+    ssd1306_arrow_left,
+    ssd1306_arrow_right,
+    ssd1306_arrow_up_left,
+    ssd1306_arrow_up_right,
+    ssd1306_arrow_down_left,
+    ssd1306_arrow_down_right
+} ssd1306_arrow_t;
+
+typedef struct {
+    int16_t x, y;          // Canto superior esquerdo da área do widget
+    int16_t width, height; // Área apagada a cada redesenho
+    uint8_t scale;         // Ampliação do texto
+    const ssd1306_font_t *font; // Fonte gerada (ssd1306_fonts.h) no lugar da fonte 8x8 ampliada; NULL: 8x8
+    bool valid;            // false: redesenha no próximo set, mesmo sem mudança de valor
+    const char *text;      // Rótulo: texto fixo; valor numérico: sufixo (ex.: "°C")
+    uint8_t decimals;      // Valor numérico: casas decimais do ponto fixo
+    int32_t value;         // Valor exibido (número, direção da seta, nível da barra ou deslocamento do letreiro)
+    int32_t max;           // Barra: valor da barra cheia; letreiro: largura do texto em pixels
+    char shown[ssd1306_widget_text_max]; // Seta: legenda exibida; letreiro: texto em Latin-1
+} ssd1306_widget_t;
+
+extern void ssd1306_label_init(ssd1306_widget_t *widget, int x, int y, const char *text, int scale);
+extern void ssd1306_value_init(ssd1306_widget_t *widget, int x, int y, int width, int decimals, const char *suffix, int scale);
+extern void ssd1306_value_init_font(ssd1306_widget_t *widget, int x, int y, int width, int decimals, const char *suffix, const ssd1306_font_t *font);
+extern void ssd1306_arrow_init(ssd1306_widget_t *widget, int x, int y, int width);
+extern void ssd1306_bar_init(ssd1306_widget_t *widget, int x, int y, int width, int height, int32_t max);
+extern void ssd1306_marquee_init(ssd1306_widget_t *widget, int x, int y, int width);
+extern void ssd1306_widget_invalidate(ssd1306_widget_t *widget);
+extern bool ssd1306_label_draw(ssd1306_t *ssd, ssd1306_widget_t *widget);
+extern bool ssd1306_value_set(ssd1306_t *ssd, ssd1306_widget_t *widget, int32_t value);
+extern bool ssd1306_arrow_set(ssd1306_t *ssd, ssd1306_widget_t *widget, const char *caption, ssd1306_arrow_t direction);
+extern bool ssd1306_bar_set(ssd1306_t *ssd, ssd1306_widget_t *widget, int32_t value);
+extern bool ssd1306_marquee_set(ssd1306_t *ssd, ssd1306_widget_t *widget, const char *text);
+extern bool ssd1306_marquee_step(ssd1306_t *ssd, ssd1306_widget_t *widget, int pixels);
+extern bool ssd1306_marquee_scrolling(const ssd1306_widget_t *widget);
+extern bool ssd1306_marquee_hardware(ssd1306_t *ssd, ssd1306_widget_t *widget, uint8_t interval);
+extern bool ssd1306_marquee_hardware_lines(ssd1306_t *ssd, ssd1306_widget_t *lines, int count, uint8_t interval);
+
+#endif
@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+"""Converte fontes BDF em tabelas de glifos para o SSD1306 (ssd1306_font_t).
+
+Cada glifo vira um bitmap no formato de ram_buffer: colunas de 8 pixels (bit 0 no topo),
+agrupadas página a página, com a altura da fonte arredondada para páginas inteiras. Assim o
+renderizador copia um glifo com operações de byte (ssd1306_blit_bitmap), sem ler pixel a pixel.
+A largura de cada glifo é o seu avanço (DWIDTH), então o espaçamento já vem apagado no bitmap.
+
+Uso: bdf2ssd1306.py -o ssd1306_fonts.c nome=fonte.bdf [nome=fonte.bdf ...]
+     bdf2ssd1306.py --preview fonte.bdf   (mostra os glifos em texto, para conferência)
+"""
+
+import argparse
+import sys
+
+
+class Glyph:
+    def __init__(self, encoding, advance, columns):
+        self.encoding = encoding
+        self.advance = advance
+        self.columns = columns  # Uma palavra por coluna, bit 0 na linha de cima da fonte
+
+
+def parse_bdf(path):
+    """Lê uma fonte BDF e devolve (altura, linha de base, glifos Latin-1)."""
+    ascent = descent = None
+    default_char = None
+    glyphs = []
+
+    with open(path, encoding="latin-1") as f:
+        lines = iter(f.read().splitlines())
+
+    for line in lines:
+        words = line.split()
+        if not words:
+            continue
+        if words[0] == "FONT_ASCENT":
+            ascent = int(words[1])
+        elif words[0] == "FONT_DESCENT":
+            descent = int(words[1])
+        elif words[0] == "DEFAULT_CHAR":
+            default_char = int(words[1])
+        elif words[0] == "STARTCHAR":
+            encoding = advance = None
+            bbx = (0, 0, 0, 0)
+            for line in lines:
+                words = line.split()
+                if words[0] == "ENCODING":
+                    encoding = int(words[1])
+                elif words[0] == "DWIDTH":
+                    advance = int(words[1])
+                elif words[0] == "BBX":
+                    bbx = tuple(int(w) for w in words[1:5])
+                elif words[0] == "BITMAP":
+                    break
+
+            width, height, x_offset, y_offset = bbx
+            rows = [int(next(lines), 16) for _ in range(height)]
+            if next(lines).strip() != "ENDCHAR":
+                sys.exit("%s: glifo %s com BITMAP mais longo que o BBX" % (path, encoding))
+            if encoding is None or not 0 <= encoding <= 0xFF:
+                continue  # Só Latin-1: o texto é decodificado por ssd1306_next_char
+
+            if ascent is None or descent is None:
+                sys.exit("%s: FONT_ASCENT/FONT_DESCENT ausentes" % path)
+            row_bits = ((width + 7) // 8) * 8
+            top = ascent - (y_offset + height)  # Linha da fonte onde começa o BBX
+            columns = [0] * advance
+            for r, bits in enumerate(rows):
+                y = top + r
+                for c in range(width):
+                    x = x_offset + c
+                    if bits >> (row_bits - 1 - c) & 1:
+                        if not (0 <= x < advance and 0 <= y < ascent + descent):
+                            sys.exit("%s: glifo %d sai da célula da fonte" % (path, encoding))
+                        columns[x] |= 1 << y
+            glyphs.append(Glyph(encoding, advance, columns))
+
+    if ascent is None or descent is None:
+        sys.exit("%s: FONT_ASCENT/FONT_DESCENT ausentes" % path)
+
+    # O glifo 0 substitui os caracteres ausentes: DEFAULT_CHAR, ou espaço, ou o primeiro glifo
+    fallback = next((g for g in glyphs if g.encoding == default_char), None) \
+        or next((g for g in glyphs if g.encoding == 0x20), glyphs[0])
+    glyphs.remove(fallback)
+    glyphs.insert(0, fallback)
+    return ascent + descent, ascent, glyphs
+
+
+def pack(glyph, pages):
+    """Bytes do glifo página a página, como ram_buffer."""
+    return [(column >> (8 * page)) & 0xFF for page in range(pages) for column in glyph.columns]
+
+
+def emit(fonts, output):
+    out = ["// Gerado por lib/ssd1306/tools/bdf2ssd1306.py a partir de lib/ssd1306/fonts/*.bdf.",
+           "// Não edite: altere a fonte BDF e recompile.",
+           "",
+           "#include \"ssd1306_fonts.h\"",
+           ""]
+
+    for name, path in fonts:
+        height, baseline, glyphs = parse_bdf(path)
+        pages = (height + 7) // 8
+
+        bitmap, table, offset = [], [], 0
+        for glyph in glyphs:
+            data = pack(glyph, pages)
+            table.append((offset, glyph.advance, glyph.encoding))
+            bitmap.append((glyph.encoding, data))
+            offset += len(data)
+        if offset > 0xFFFF or max(g.advance for g in glyphs) > 0xFF:
+            sys.exit("%s: fonte grande demais para ssd1306_glyph_t" % path)
+
+        index = [0] * 256
+        for number, glyph in enumerate(glyphs):
+            index[glyph.encoding] = number
+
+        out.append("// %s: %d pixels (%d página%s), %d glifos, %d bytes de bitmap"
+                   % (path.split("/")[-1], height, pages, "s" if pages > 1 else "", len(glyphs), offset))
+        out.append("static const uint8_t %s_bitmap[] = {" % name)
+        for encoding, data in bitmap:
+            out.append("    %s // %s" % (" ".join("0x%02X," % b for b in data), describe(encoding)))
+        out.append("};")
+        out.append("")
+        out.append("static const ssd1306_glyph_t %s_glyphs[] = {" % name)
+        for offset, advance, encoding in table:
+            out.append("    {%d, %d}, // %s" % (offset, advance, describe(encoding)))
+        out.append("};")
+        out.append("")
+        out.append("static const uint8_t %s_index[256] = {" % name)
+        for row in range(0, 256, 16):
+            out.append("    " + " ".join("%d," % i for i in index[row:row + 16]))
+        out.append("};")
+        out.append("")
+        out.append("const ssd1306_font_t %s = {" % name)
+        out.append("    .bitmap = %s_bitmap," % name)
+        out.append("    .glyphs = %s_glyphs," % name)
+        out.append("    .index = %s_index," % name)
+        out.append("    .height = %d," % height)
+        out.append("    .baseline = %d," % baseline)
+        out.append("};")
+        out.append("")
+
+    with open(output, "w", encoding="utf-8") as f:
+        f.write("\n".join(out))
+
+
+def describe(encoding):
+    if encoding == 0x20:
+        return "espaço"
+    if encoding == 0x27:
+        return "apóstrofo"
+    if encoding == 0x5C:
+        return "barra invertida"
+    return "'%s'" % bytes([encoding]).decode("latin-1") if encoding > 0x20 and encoding != 0x7F else "0x%02X" % encoding
+
+
+def preview(path):
+    height, baseline, glyphs = parse_bdf(path)
+    for glyph in glyphs:
+        print("%s (avanço %d)" % (describe(glyph.encoding), glyph.advance))
+        for y in range(height):
+            marker = "-" if y == baseline else " "
+            print(marker + "".join("#" if c >> y & 1 else "." for c in glyph.columns))
+        print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("-o", "--output", help="arquivo .c gerado")
+    parser.add_argument("--preview", metavar="BDF", help="mostra os glifos de uma fonte e sai")
+    parser.add_argument("fonts", nargs="*", metavar="nome=fonte.bdf")
+    args = parser.parse_args()
+
+    if args.preview:
+        preview(args.preview)
+        return
+    if not args.output or not args.fonts:
+        parser.error("informe -o e ao menos uma fonte")
+
+    fonts = []
+    for spec in args.fonts:
+        name, sep, path = spec.partition("=")
+        if not sep or not name.isidentifier():
+            parser.error("fonte inválida: %s (esperado nome=arquivo.bdf)" % spec)
+        fonts.append((name, path))
+    emit(fonts, args.output)
+
+
+if __name__ == "__main__":
+    main()
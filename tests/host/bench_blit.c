@@ -0,0 +1,127 @@
+#include <stdlib.h>
+#include <string.h>
+#include "ssd1306.h"
+#include "ssd1306_emulator.h"
+#include "host_test.h"
+
+// Cópia de bitmaps: confere ssd1306_blit_bitmap pixel a pixel contra uma cópia de referência
+// (ssd1306_set_pixel), em posições alinhadas ou não às páginas e cortadas pelas bordas, e mede os
+// bytes I2C de cada cópia. ssd1306_draw_bitmap envia um quadro; ssd1306_draw_bitmap_area envia só
+// as janelas alteradas: em cada página tocada, 0x00 + 6 comandos e 0x40 + as colunas visíveis
+
+#define blit_repeats 2000
+
+typedef struct {
+    const char *name;
+    int x, y, width, height;
+} blit_case_t;
+
+static const blit_case_t cases[] = {
+    {"16x16 em (8, 8), alinhado", 8, 8, 16, 16},
+    {"16x16 em (8, 13)", 8, 13, 16, 16},
+    {"32x20 em (50, 3)", 50, 3, 32, 20},
+    {"128x10 em (0, 27)", 0, 27, 128, 10},
+    {"24x24 em (-5, -7), cortado", -5, -7, 24, 24},
+    {"7x5 em (124, 61), cortado", 124, 61, 7, 5},
+};
+
+static ssd1306_t display;
+static ssd1306_t reference; // Sem display ligado: só o framebuffer
+static ssd1306_emulator_t panel;
+static uint8_t bitmap[ssd1306_buffer_length];
+
+// Fundo com um padrão, para verificar que os pixels vizinhos ao bitmap são preservados
+static void fill_background(ssd1306_t *ssd) {
+    for (int i = 1; i < (int)ssd->bufsize; i++) {
+        ssd->ram_buffer[i] = (uint8_t)(i * 37 + 0x5A);
+    }
+}
+
+static void reference_blit(ssd1306_t *ssd, const uint8_t *source, int x, int y, int width, int height) {
+    for (int row = 0; row < height; row++) {
+        for (int col = 0; col < width; col++) {
+            int px = x + col, py = y + row;
+            if (px < 0 || px >= ssd->width || py < 0 || py >= ssd->height) {
+                continue;
+            }
+            ssd1306_set_pixel(ssd, px, py, source[(row / 8) * width + col] >> (row % 8) & 1);
+        }
+    }
+}
+
+// Páginas e colunas da tela cobertas pelo bitmap
+static int visible_pages(const blit_case_t *c) {
+    int top = c->y < 0 ? 0 : c->y;
+    int bottom = c->y + c->height - 1 < ssd1306_height - 1 ? c->y + c->height - 1 : ssd1306_height - 1;
+    return bottom / 8 - top / 8 + 1;
+}
+
+static int visible_columns(const blit_case_t *c) {
+    int left = c->x < 0 ? 0 : c->x;
+    int right = c->x + c->width - 1 < ssd1306_width - 1 ? c->x + c->width - 1 : ssd1306_width - 1;
+    return right - left + 1;
+}
+
+static void bench_full(void) {
+    ssd1306_emulator_reset_counters(&panel);
+    uint64_t start = pico_host_time_ns();
+    for (int i = 0; i < blit_repeats; i++) {
+        ssd1306_draw_bitmap(&display, bitmap);
+    }
+    uint64_t elapsed = pico_host_time_ns() - start;
+
+    double bytes = (double)panel.bytes / blit_repeats;
+    double transactions = (double)panel.transactions / blit_repeats;
+    printf("%-30s %9.2f %9.0f %7.1f\n", "tela inteira (draw_bitmap)", elapsed / 1000.0 / blit_repeats, bytes, transactions);
+
+    check(ssd1306_emulator_matches(&panel, &display));
+    check(panel.bytes == blit_repeats * (7 + 1 + ssd1306_buffer_length));
+    check(panel.transactions == blit_repeats * 2);
+}
+
+static void bench_area(const blit_case_t *c) {
+    // Confere o framebuffer contra a cópia de referência, sobre o mesmo fundo
+    fill_background(&display);
+    fill_background(&reference);
+    ssd1306_send_data(&display);
+    ssd1306_blit_bitmap(&display, bitmap, c->x, c->y, c->width, c->height);
+    reference_blit(&reference, bitmap, c->x, c->y, c->width, c->height);
+    check(memcmp(display.ram_buffer, reference.ram_buffer, display.bufsize) == 0);
+
+    // Tráfego de uma cópia com envio das janelas alteradas
+    ssd1306_send_data(&display);
+    ssd1306_emulator_reset_counters(&panel);
+    ssd1306_draw_bitmap_area(&display, bitmap, c->x, c->y, c->width, c->height);
+    check(ssd1306_emulator_matches(&panel, &display));
+    uint32_t bytes = panel.bytes;
+    uint32_t transactions = panel.transactions;
+    check(bytes == (uint32_t)(visible_pages(c) * (7 + 1 + visible_columns(c))));
+    check(transactions == (uint32_t)(2 * visible_pages(c)));
+
+    // Tempo de CPU só da cópia para o framebuffer
+    uint64_t start = pico_host_time_ns();
+    for (int i = 0; i < blit_repeats; i++) {
+        ssd1306_blit_bitmap(&display, bitmap, c->x, c->y, c->width, c->height);
+    }
+    uint64_t elapsed = pico_host_time_ns() - start;
+
+    printf("%-30s %9.3f %9lu %7lu\n", c->name, elapsed / 1000.0 / blit_repeats,
+           (unsigned long)bytes, (unsigned long)transactions);
+}
+
+int main(void) {
+    ssd1306_emulator_attach(&panel, i2c1, ssd1306_i2c_address);
+    ssd1306_init(&display, ssd1306_width, ssd1306_height, false, ssd1306_i2c_address, i2c1);
+    ssd1306_init(&reference, ssd1306_width, ssd1306_height, false, ssd1306_i2c_address + 1, i2c1);
+
+    for (int i = 0; i < (int)sizeof(bitmap); i++) {
+        bitmap[i] = (uint8_t)(i * 73 + (i >> 3));
+    }
+
+    printf("%-30s %9s %9s %7s\n", "cópia", "CPU (us)", "bytes", "trans.");
+    bench_full();
+    for (size_t i = 0; i < count_of(cases); i++) {
+        bench_area(&cases[i]);
+    }
+    return host_test_result();
+}
@@ -0,0 +1,120 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "imu_fft.h"
+#include "imu_stats.h"
+#include "host_test.h"
+
+// FFT em ponto fixo do espectro de vibração (Tarefa_3/inc/imu_fft.c): ciclos por transformada
+// de 128 a 1024 pontos e precisão contra uma DFT em double da mesma entrada, com a mesma escala
+// 1/N. Os ciclos são da CPU do PC; na placa o tempo de um quadro (três eixos) sai em
+// transform_us. Depois um quadro completo com senoides conhecidas passa por imu_fft_add e
+// imu_fft_process, e os picos e a energia das faixas são conferidos
+
+#define fft_repeats 2000
+#define fft_sample_rate_hz 1000
+
+// Gerador congruente: a mesma entrada em qualquer libc
+static uint32_t random_state = 12345;
+
+static int32_t random_range(int32_t range) {
+    random_state = random_state * 1664525u + 1013904223u;
+    return (int32_t)((random_state >> 8) % (2 * range + 1)) - range;
+}
+
+static void bench_transform(uint points) {
+    static int16_t re[IMU_FFT_MAX_POINTS], im[IMU_FFT_MAX_POINTS];
+    static int16_t out_re[IMU_FFT_MAX_POINTS], out_im[IMU_FFT_MAX_POINTS];
+
+    // Ruído com |x| < 2^13, abaixo do limite de 2^14 da FFT
+    for (uint i = 0; i < points; i++) {
+        re[i] = (int16_t)random_range(8191);
+        im[i] = (int16_t)random_range(8191);
+    }
+
+    uint64_t start = pico_host_cycles();
+    for (int r = 0; r < fft_repeats; r++) {
+        memcpy(out_re, re, points * sizeof(re[0]));
+        memcpy(out_im, im, points * sizeof(im[0]));
+        check(imu_fft_q15(out_re, out_im, points));
+    }
+    double cycles = (double)(pico_host_cycles() - start) / fft_repeats;
+
+    // DFT direta em double, escalada por 1/N como a FFT
+    double signal = 0.0, noise = 0.0, max_error = 0.0;
+    for (uint k = 0; k < points; k++) {
+        double sum_re = 0.0, sum_im = 0.0;
+        for (uint t = 0; t < points; t++) {
+            double angle = -2.0 * M_PI * (double)((k * t) % points) / points;
+            sum_re += re[t] * cos(angle) - im[t] * sin(angle);
+            sum_im += re[t] * sin(angle) + im[t] * cos(angle);
+        }
+        sum_re /= points;
+        sum_im /= points;
+        double error_re = out_re[k] - sum_re, error_im = out_im[k] - sum_im;
+        signal += sum_re * sum_re + sum_im * sum_im;
+        noise += error_re * error_re + error_im * error_im;
+        max_error = fmax(max_error, hypot(error_re, error_im));
+    }
+    double snr_db = 10.0 * log10(signal / noise);
+
+    printf("%6u %12.0f %12.1f %10.1f %10.2f\n", points, cycles, cycles / points, snr_db, max_error);
+    // Com a escala de um bit por estágio o ruído de arredondamento cresce com os estágios
+    check(snr_db >= 40.0);
+    check(max_error <= 8.0);
+}
+
+// Um quadro de 1024 amostras: 60,3 Hz com 200 mg no x, 180 Hz com 50 mg no y sobre um
+// deslocamento, 1 g constante no z; ruído de ±10 unidades no x e no z
+static void check_spectrum(void) {
+    static const uint16_t edges[IMU_FFT_BANDS + 1] = IMU_FFT_DEFAULT_BAND_EDGES;
+    const double raw_per_mg = 16.384;
+    check(imu_fft_init(IMU_FFT_MAX_POINTS, fft_sample_rate_hz, edges));
+
+    for (int i = 0; i < IMU_FFT_MAX_POINTS; i++) {
+        double t = (double)i / fft_sample_rate_hz;
+        int16_t accel[3] = {
+            (int16_t)lround(200 * raw_per_mg * sin(2 * M_PI * 60.3 * t)) + random_range(10),
+            (int16_t)lround(50 * raw_per_mg * sin(2 * M_PI * 180.0 * t) + 300),
+            (int16_t)(16384 + random_range(10)),
+        };
+        imu_fft_add(accel);
+    }
+
+    uint64_t start = pico_host_cycles();
+    check(imu_fft_process());
+    uint64_t cycles = pico_host_cycles() - start;
+
+    imu_fft_spectrum_t spectrum;
+    check(imu_fft_read(&spectrum) == 1);
+    char text[600];
+    imu_fft_format(text, sizeof(text), &spectrum);
+    printf("quadro de %d pontos, três eixos: %llu ciclos\n%s\n", IMU_FFT_MAX_POINTS, (unsigned long long)cycles, text);
+
+    // Pico principal: frequência interpolada a 0,5 Hz e amplitude a 5%
+    const imu_fft_peaks_t *x = &spectrum.peaks[0], *y = &spectrum.peaks[1];
+    check(abs(x->frequency_dhz[0] - 603) <= 5);
+    check(abs(x->amplitude_mg[0] - 200) <= 10);
+    check(abs(y->frequency_dhz[0] - 1800) <= 5);
+    check(abs(y->amplitude_mg[0] - 50) <= 3);
+
+    // A senoide inteira cai numa faixa, com o RMS de uma senoide (amplitude / raiz de 2)
+    check(abs(spectrum.bands[0].band_mg[2] - 141) <= 7); // 50 a 150 Hz
+    check(abs(spectrum.bands[1].band_mg[3] - 35) <= 2);  // 150 a 500 Hz
+    check(spectrum.bands[1].band_mg[0] == 0);            // O deslocamento sai com a média
+    check(spectrum.bands[2].rms_mg <= 2);                // Só ruído no z
+}
+
+int main(void) {
+    imu_stats_config_t config = IMU_STATS_DEFAULT_CONFIG;
+    imu_stats_init(&config, fft_sample_rate_hz);
+
+    printf("%6s %12s %12s %10s %10s\n", "pontos", "ciclos", "ciclos/pt", "SNR (dB)", "erro máx");
+    for (uint points = IMU_FFT_MIN_POINTS; points <= IMU_FFT_MAX_POINTS; points <<= 1) {
+        bench_transform(points);
+    }
+    check(!imu_fft_q15(NULL, NULL, 100)); // Não é potência de 2
+
+    check_spectrum();
+    return host_test_result();
+}
@@ -0,0 +1,125 @@
+#include <stdlib.h>
+#include <string.h>
+#include "ssd1306.h"
+#include "host_test.h"
+
+// Primitivas por byte contra o desenho pixel a pixel: cada primitiva (hline, vline, rect,
+// fill_rect, clear_rect) é conferida contra a versão de referência, que usa o Bresenham genérico
+// ou ssd1306_set_pixel como antes, e as duas são medidas em pixels por segundo. As linhas
+// diagonais continuam no Bresenham e entram como base de comparação
+
+#define primitive_repeats 20000
+
+static ssd1306_t fast;
+static ssd1306_t reference;
+
+// Bresenham sem os atalhos de ssd1306_draw_line: um ssd1306_set_pixel por pixel
+static void reference_line(ssd1306_t *ssd, int x_0, int y_0, int x_1, int y_1, bool set) {
+    int dx = abs(x_1 - x_0);
+    int dy = -abs(y_1 - y_0);
+    int sx = x_0 < x_1 ? 1 : -1;
+    int sy = y_0 < y_1 ? 1 : -1;
+    int error = dx + dy;
+
+    while (true) {
+        ssd1306_set_pixel(ssd, x_0, y_0, set);
+        if (x_0 == x_1 && y_0 == y_1) {
+            break;
+        }
+        int error_2 = 2 * error;
+        if (error_2 >= dy) {
+            error += dy;
+            x_0 += sx;
+        }
+        if (error_2 <= dx) {
+            error += dx;
+            y_0 += sy;
+        }
+    }
+}
+
+static void reference_fill(ssd1306_t *ssd, int x, int y, int width, int height, bool set) {
+    for (int row = y; row < y + height; row++) {
+        for (int col = x; col < x + width; col++) {
+            ssd1306_set_pixel(ssd, col, row, set);
+        }
+    }
+}
+
+// Cada caso desenha a mesma figura pelos dois caminhos; `pixels` é o número de pixels da figura
+typedef struct {
+    const char *name;
+    int pixels;
+    void (*fast)(ssd1306_t *ssd, int i);
+    void (*reference)(ssd1306_t *ssd, int i);
+} primitive_case_t;
+
+// O deslocamento i varia a posição (e o alinhamento às páginas) a cada repetição
+static void hline_fast(ssd1306_t *ssd, int i) { ssd1306_hline(ssd, 10, i % 64, 100, true); }
+static void hline_reference(ssd1306_t *ssd, int i) { reference_line(ssd, 10, i % 64, 109, i % 64, true); }
+static void vline_fast(ssd1306_t *ssd, int i) { ssd1306_vline(ssd, i % 128, 3, 58, true); }
+static void vline_reference(ssd1306_t *ssd, int i) { reference_line(ssd, i % 128, 3, i % 128, 60, true); }
+static void rect_fast(ssd1306_t *ssd, int i) { ssd1306_rect(ssd, 10, 3 + i % 8, 100, 50, true); }
+
+static void rect_reference(ssd1306_t *ssd, int i) {
+    int y = 3 + i % 8;
+    reference_line(ssd, 10, y, 109, y, true);
+    reference_line(ssd, 10, y + 49, 109, y + 49, true);
+    reference_line(ssd, 10, y, 10, y + 49, true);
+    reference_line(ssd, 109, y, 109, y + 49, true);
+}
+
+static void fill_fast(ssd1306_t *ssd, int i) { ssd1306_fill_rect(ssd, 10, 3 + i % 8, 100, 50, true); }
+static void fill_reference(ssd1306_t *ssd, int i) { reference_fill(ssd, 10, 3 + i % 8, 100, 50, true); }
+static void clear_fast(ssd1306_t *ssd, int i) { ssd1306_clear_rect(ssd, 10, 3 + i % 8, 100, 50); }
+static void clear_reference(ssd1306_t *ssd, int i) { reference_fill(ssd, 10, 3 + i % 8, 100, 50, false); }
+static void diagonal_fast(ssd1306_t *ssd, int i) { ssd1306_draw_line(ssd, 0, i % 64, 127, 63 - i % 64, true); }
+static void diagonal_reference(ssd1306_t *ssd, int i) { reference_line(ssd, 0, i % 64, 127, 63 - i % 64, true); }
+
+static const primitive_case_t cases[] = {
+    {"hline 100 px", 100, hline_fast, hline_reference},
+    {"vline 58 px", 58, vline_fast, vline_reference},
+    {"rect 100x50", 2 * 100 + 2 * 48, rect_fast, rect_reference},
+    {"fill_rect 100x50", 100 * 50, fill_fast, fill_reference},
+    {"clear_rect 100x50", 100 * 50, clear_fast, clear_reference},
+    {"draw_line diagonal (Bresenham)", 128, diagonal_fast, diagonal_reference},
+};
+
+// Pixels por segundo, em milhões
+static double measure(void (*draw)(ssd1306_t *ssd, int i), ssd1306_t *ssd, int pixels) {
+    uint64_t start = pico_host_time_ns();
+    for (int i = 0; i < primitive_repeats; i++) {
+        draw(ssd, i);
+    }
+    uint64_t elapsed = pico_host_time_ns() - start;
+    return (double)pixels * primitive_repeats / elapsed * 1000.0;
+}
+
+static void fill_background(ssd1306_t *ssd) {
+    for (int i = 1; i < (int)ssd->bufsize; i++) {
+        ssd->ram_buffer[i] = (uint8_t)(i * 29 + 0x33);
+    }
+}
+
+int main(void) {
+    // Sem display ligado: as primitivas só alteram o framebuffer
+    ssd1306_init(&fast, ssd1306_width, ssd1306_height, false, ssd1306_i2c_address, i2c1);
+    ssd1306_init(&reference, ssd1306_width, ssd1306_height, false, ssd1306_i2c_address, i2c1);
+
+    printf("%-32s %12s %12s %8s\n", "primitiva", "Mpixels/s", "referência", "ganho");
+    for (size_t c = 0; c < count_of(cases); c++) {
+        // Mesmo resultado nos dois caminhos, em várias posições sobre um fundo com padrão
+        for (int i = 0; i < 64; i++) {
+            fill_background(&fast);
+            fill_background(&reference);
+            cases[c].fast(&fast, i);
+            cases[c].reference(&reference, i);
+            check(memcmp(fast.ram_buffer, reference.ram_buffer, fast.bufsize) == 0);
+        }
+
+        double fast_rate = measure(cases[c].fast, &fast, cases[c].pixels);
+        double reference_rate = measure(cases[c].reference, &reference, cases[c].pixels);
+        printf("%-32s %12.1f %12.1f %7.1fx\n", cases[c].name, fast_rate, reference_rate, fast_rate / reference_rate);
+    }
+    return host_test_result();
+}
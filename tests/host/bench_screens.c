@@ -0,0 +1,319 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ssd1306_widget.h"
+#include "ssd1306_emulator.h"
+#include "host_test.h"
+
+// Benchmark das telas das tarefas no display simulado. Cada cena repete as chamadas da biblioteca
+// feitas pelas telas de vdisplayTask (Tarefa_1 e Tarefa_2), display_message (Tarefa_3) e
+// display_message_init (Tarefa_4) e mede, por quadro, o tempo de CPU do desenho no framebuffer e
+// do envio, os bytes e transações I2C e o tempo estimado no barramento a ssd1306_i2c_clock (no PC
+// o envio inclui a decodificação do display simulado; na placa o custo dele é o barramento).
+// Depois de cada quadro a GDDRAM simulada tem que ser igual ao framebuffer, e os bytes por quadro
+// têm um teto: uma regressão no custo de barramento faz o teste falhar
+//
+// Uso: bench_screens [--snapshots diretório] (grava a última tela de cada cena em PBM)
+
+#define bench_frames 2000
+
+// Clocks do I2C por transação (START, endereço com ACK e STOP) e por byte (8 bits e ACK)
+#define bench_bus_transaction_clocks 11
+#define bench_bus_byte_clocks 9
+
+static ssd1306_t display;
+static ssd1306_emulator_t panel;
+
+typedef struct {
+    const char *name;
+    const char *snapshot;           // Nome do arquivo PBM
+    void (*setup)(void);            // Estado anterior ao primeiro quadro (não medido)
+    void (*draw)(int frame);        // Desenho de um quadro no framebuffer
+    void (*flush)(void);            // Envio do quadro ao display
+    uint32_t max_bytes_per_frame;   // Teto de bytes I2C por quadro
+} bench_scene_t;
+
+// ===== TAREFA_1 E TAREFA_2: vdisplayTask =====
+
+static ssd1306_widget_t temp_label, temp_value, joystick_label, movement_arrow;
+
+// Direções do joystick na ordem de joystick_direction_t (0: centro), com as setas de vdisplayTask
+static const char *const movement_names[] = {
+    "Centro", "Cima", "Cima-Dir", "Direita", "Baixo-Dir", "Baixo", "Baixo-Esq", "Esquerda", "Cima-Esq",
+};
+
+static const ssd1306_arrow_t movement_arrows[] = {
+    ssd1306_arrow_none, ssd1306_arrow_up, ssd1306_arrow_up_right, ssd1306_arrow_right,
+    ssd1306_arrow_down_right, ssd1306_arrow_down, ssd1306_arrow_down_left, ssd1306_arrow_left,
+    ssd1306_arrow_up_left,
+};
+
+// Moldura e rótulos fixos, desenhados uma vez no início da tarefa
+static void vdisplay_frame(int frame) {
+    (void)frame;
+    ssd1306_clear(&display);
+    ssd1306_label_init(&temp_label, 15, 5, "Temperatura:", 1);
+    ssd1306_value_init_font(&temp_value, 28, 18, ssd1306_width - 28, 1, "°C", &ssd1306_font_num16);
+    ssd1306_label_init(&joystick_label, 25, 39, "Joystick:", 1);
+    ssd1306_arrow_init(&movement_arrow, 25, 54, ssd1306_width - 25);
+
+    ssd1306_rect(&display, 10, 0, 101, 16, true);
+    ssd1306_label_draw(&display, &temp_label);
+    ssd1306_rect(&display, 20, 35, 81, 15, true);
+    ssd1306_label_draw(&display, &joystick_label);
+}
+
+static void vdisplay_update(int32_t temperature_tenths, int movement) {
+    ssd1306_value_set(&display, &temp_value, temperature_tenths);
+    ssd1306_arrow_set(&display, &movement_arrow, movement_names[movement], movement_arrows[movement]);
+}
+
+static void vdisplay_setup(void) {
+    vdisplay_frame(0);
+    vdisplay_update(253, 0);
+    ssd1306_send_data(&display);
+}
+
+// Só a temperatura muda (leitura nova a cada quadro, joystick parado)
+static void vdisplay_temperature(int frame) {
+    vdisplay_update(253 + (frame & 7), 0);
+}
+
+// Temperatura e direção do joystick mudam juntas
+static void vdisplay_temperature_joystick(int frame) {
+    vdisplay_update(253 + (frame & 7), 1 + frame % 8);
+}
+
+static void send_data(void) {
+    ssd1306_send_data(&display);
+}
+
+static void send_dirty(void) {
+    render_dirty_on_display(&display);
+}
+
+// ===== TAREFA_3: display_message =====
+
+typedef struct {
+    float accel_x, accel_y, accel_z; // em g
+    float gyro_x, gyro_y, gyro_z;    // em °/s
+    float temperature;               // em °C
+} bench_mpu6050_data_t;
+
+static ssd1306_widget_t accel_value[3], gyro_value[3], imu_temp_value;
+static bool dashboard_drawn;
+
+static void display_message(const bench_mpu6050_data_t *sensor_data) {
+    if (!dashboard_drawn) {
+        static const char *axis[3] = {"X:", "Y:", "Z:"};
+        static const int row[3] = {16, 32, 45};
+
+        ssd1306_clear(&display);
+        ssd1306_draw_string(&display, 10, 0, "ACEL.");
+        ssd1306_draw_string(&display, 70, 0, "GIROS.");
+        ssd1306_draw_line(&display, 0, 12, 150, 12, true);
+        for (int i = 0; i < 3; i++) {
+            ssd1306_draw_string(&display, 0, row[i], axis[i]);
+            ssd1306_value_init(&accel_value[i], 24, row[i], 48, 2, NULL, 1);
+            ssd1306_value_init(&gyro_value[i], 72, row[i], ssd1306_width - 72, 2, NULL, 1);
+        }
+        ssd1306_draw_string(&display, 0, 56, "Temp:");
+        ssd1306_value_init(&imu_temp_value, 48, 56, ssd1306_width - 48, 1, " °C", 1);
+        dashboard_drawn = true;
+    }
+
+    ssd1306_value_set(&display, &accel_value[0], lroundf(sensor_data->accel_x * 100.0f));
+    ssd1306_value_set(&display, &accel_value[1], lroundf(sensor_data->accel_y * 100.0f));
+    ssd1306_value_set(&display, &accel_value[2], lroundf(sensor_data->accel_z * 100.0f));
+    ssd1306_value_set(&display, &gyro_value[0], lroundf(sensor_data->gyro_x * 100.0f));
+    ssd1306_value_set(&display, &gyro_value[1], lroundf(sensor_data->gyro_y * 100.0f));
+    ssd1306_value_set(&display, &gyro_value[2], lroundf(sensor_data->gyro_z * 100.0f));
+    ssd1306_value_set(&display, &imu_temp_value, lroundf(sensor_data->temperature * 10.0f));
+}
+
+// Leituras do sensor que mudam em todos os campos a cada quadro
+static void imu_sample(int frame, bench_mpu6050_data_t *data) {
+    float t = frame * 0.05f;
+    *data = (bench_mpu6050_data_t){
+        .accel_x = 0.3f * sinf(t), .accel_y = -0.2f * cosf(t), .accel_z = 0.98f + 0.01f * (frame & 3),
+        .gyro_x = 12.5f * sinf(2 * t), .gyro_y = -7.25f * cosf(t), .gyro_z = 1.5f + 0.01f * frame,
+        .temperature = 27.0f + 0.1f * (frame & 7),
+    };
+}
+
+static void imu_setup(void) {
+    bench_mpu6050_data_t data;
+    imu_sample(0, &data);
+    dashboard_drawn = false;
+    display_message(&data);
+    ssd1306_send_data(&display);
+    ssd1306_async_init(&display);
+}
+
+// Tela refeita (volta de uma mensagem de status)
+static void imu_dashboard(int frame) {
+    bench_mpu6050_data_t data;
+    imu_sample(frame, &data);
+    dashboard_drawn = false;
+    display_message(&data);
+}
+
+static void imu_values(int frame) {
+    bench_mpu6050_data_t data;
+    imu_sample(frame + 1, &data);
+    display_message(&data);
+}
+
+// Envio por DMA, como no fim de display_message
+static void send_async(void) {
+    if (ssd1306_is_dirty(&display)) {
+        render_on_display_async(&display, NULL, NULL);
+    }
+}
+
+// ===== TAREFA_4: display_message_init =====
+
+static ssd1306_widget_t status_lines[5];
+
+static void display_message_init(const char *line1, const char *line2, const char *line3, const char *line4, const char *line5) {
+    static const int line_x[5] = {5, 5, 0, 0, 0};
+    static const int line_y[5] = {0, 16, 32, 48, 56};
+    const char *lines[5] = {line1, line2, line3, line4, line5};
+
+    ssd1306_clear(&display);
+    for (int i = 0; i < 5; i++) {
+        ssd1306_marquee_init(&status_lines[i], line_x[i], line_y[i], ssd1306_width - line_x[i]);
+        if (lines[i]) {
+            ssd1306_marquee_set(&display, &status_lines[i], lines[i]);
+        }
+    }
+}
+
+// Tela de um botão pressionado (alterna entre A e B, com a temperatura atual)
+static void status_buttons(int frame) {
+    char temperature[16];
+    snprintf(temperature, sizeof(temperature), "%d.%02d°C", 25 + (frame & 3), frame % 100);
+    if (frame & 1) {
+        display_message_init("Temperatura:", temperature, "Bot.A Precionado", "Bot. B solto.", NULL);
+    }
+    else {
+        display_message_init("Temperatura:", temperature, "Bot. A solto", "Bot.B Precionado.", NULL);
+    }
+}
+
+static void status_setup(void) {
+    status_buttons(0);
+    ssd1306_send_data(&display);
+}
+
+// Passo de display_marquee_task: "Bot.B Precionado." não cabe na linha e rola 2 pixels
+static void status_marquee(int frame) {
+    (void)frame;
+    for (int i = 0; i < 5; i++) {
+        ssd1306_marquee_step(&display, &status_lines[i], 2);
+    }
+}
+
+// ===== EXECUÇÃO =====
+
+static const bench_scene_t scenes[] = {
+    {"Tarefa_1/2 vdisplayTask: moldura", "vdisplay_moldura", NULL, vdisplay_frame, send_data, 1032},
+    {"Tarefa_1/2 vdisplayTask: temperatura", "vdisplay_temperatura", vdisplay_setup, vdisplay_temperature, send_dirty, 330},
+    {"Tarefa_1/2 vdisplayTask: temp. + joystick", "vdisplay_joystick", vdisplay_setup, vdisplay_temperature_joystick, send_dirty, 560},
+    {"Tarefa_3 display_message: painel", "display_message_painel", imu_setup, imu_dashboard, send_async, 1032},
+    {"Tarefa_3 display_message: valores", "display_message_valores", imu_setup, imu_values, send_async, 1032},
+    {"Tarefa_4 display_message_init", "display_message_init", NULL, status_buttons, send_data, 1032},
+    {"Tarefa_4 letreiro (passo de 2 px)", "letreiro", status_setup, status_marquee, send_dirty, 140},
+};
+
+static void run_scene(const bench_scene_t *scene, const char *snapshots) {
+    // Instância nova por cena: a mesma sequência de init das tarefas
+    pico_host_i2c_detach_all();
+    ssd1306_emulator_attach(&panel, i2c1, ssd1306_i2c_address);
+    if (display.async == NULL) {
+        free(display.ram_buffer);
+        ssd1306_init(&display, ssd1306_width, ssd1306_height, false, ssd1306_i2c_address, i2c1);
+    }
+    else {
+        // O envio por DMA, depois de ligado, fica com a instância: só a tela é apagada
+        ssd1306_config(&display);
+        ssd1306_clear(&display);
+        ssd1306_send_data(&display);
+    }
+
+    if (scene->setup) {
+        scene->setup();
+    }
+    ssd1306_flush_wait(&display);
+    ssd1306_emulator_reset_counters(&panel);
+
+    uint64_t draw_ns = 0, flush_ns = 0;
+    uint32_t max_bytes = 0;
+    bool matches = true;
+
+    for (int frame = 0; frame < bench_frames; frame++) {
+        uint32_t bytes_before = panel.bytes;
+
+        uint64_t start = pico_host_time_ns();
+        scene->draw(frame);
+        uint64_t drawn = pico_host_time_ns();
+        scene->flush();
+        ssd1306_flush_wait(&display);
+        uint64_t sent = pico_host_time_ns();
+
+        draw_ns += drawn - start;
+        flush_ns += sent - drawn;
+        if (panel.bytes - bytes_before > max_bytes) {
+            max_bytes = panel.bytes - bytes_before;
+        }
+        matches &= ssd1306_emulator_matches(&panel, &display);
+    }
+
+    double bytes = (double)panel.bytes / bench_frames;
+    double transactions = (double)panel.transactions / bench_frames;
+    double bus_us = (transactions * bench_bus_transaction_clocks + bytes * bench_bus_byte_clocks) * 1000.0 / ssd1306_i2c_clock;
+    printf("%-42s %9.2f %9.2f %9.1f %7.1f %6lu %9.0f\n", scene->name,
+           draw_ns / 1000.0 / bench_frames, flush_ns / 1000.0 / bench_frames,
+           bytes, transactions, (unsigned long)max_bytes, bus_us);
+
+    if (!matches) {
+        fprintf(stderr, "%s: a GDDRAM simulada diverge do framebuffer\n", scene->name);
+    }
+    if (max_bytes > scene->max_bytes_per_frame) {
+        fprintf(stderr, "%s: %lu bytes num quadro, teto de %lu\n", scene->name,
+                (unsigned long)max_bytes, (unsigned long)scene->max_bytes_per_frame);
+    }
+    check(matches);
+    check(max_bytes <= scene->max_bytes_per_frame);
+    check(panel.scroll_writes == 0);
+
+    if (snapshots) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s.pbm", snapshots, scene->snapshot);
+        if (!ssd1306_emulator_write_pbm(&panel, path, 2)) {
+            fprintf(stderr, "não foi possível gravar %s\n", path);
+            check(false);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    const char *snapshots = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--snapshots") == 0 && i + 1 < argc) {
+            snapshots = argv[++i];
+        }
+        else {
+            fprintf(stderr, "uso: %s [--snapshots diretório]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("%d quadros por cena; barramento estimado a %d kHz\n", bench_frames, ssd1306_i2c_clock);
+    printf("%-42s %9s %9s %9s %7s %6s %9s\n", "cena", "desenho", "envio", "bytes", "trans.", "máx.", "I2C");
+    printf("%-42s %9s %9s %9s %7s %6s %9s\n", "", "(us)", "(us)", "/quadro", "/quadro", "bytes", "(us)");
+    for (size_t i = 0; i < count_of(scenes); i++) {
+        run_scene(&scenes[i], snapshots);
+    }
+    return host_test_result();
+}
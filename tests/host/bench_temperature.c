@@ -0,0 +1,209 @@
+#include <math.h>
+#include <string.h>
+#include "hardware/flash.h"
+#include "temperature.h"
+#include "host_test.h"
+
+// Temperatura interna em ponto fixo contra a conta em float que as tarefas usavam
+// (read_onboard_temperature): erro em centésimos de grau contra a reta do datasheet em double,
+// para todos os códigos de 12 bits e sobreamostrados de 16 bits, e ciclos por conversão dos dois
+// caminhos. No PC o float roda na FPU; no RP2040, sem FPU, cada operação em float é uma chamada
+// à biblioteca, então a relação medida aqui é menor que a da placa. Depois confere o filtro IIR,
+// a calibração gravada na flash simulada, o comando de calibração pela serial e a formatação
+
+#define conversion_repeats 2000000
+#define calibration_magic 0x54454D50u // O mesmo de temperature.c: "TEMP"
+
+// Conta da versão anterior para uma leitura de 12 bits (noinline: os dois caminhos pagam a chamada)
+__attribute__((noinline)) static float float_temperature(uint16_t raw) {
+    const float conversion_factor = 3.3f / (1 << 12);
+    float voltage = raw * conversion_factor;
+    return 27.0f - (voltage - 0.706f) / 0.001721f;
+}
+
+// Reta do datasheet em double para o código de 16 bits, em centésimos de grau
+static double exact_centi(uint32_t code) {
+    double voltage = code * (temperature_vref_mv / 1000.0) / 65536.0;
+    return (27.0 - (voltage - temperature_v27_uv / 1e6) / (temperature_slope_uv / 1e6)) * 100.0;
+}
+
+static void check_accuracy(void) {
+    double code_error = 0.0;
+    for (uint32_t code = 0; code <= 0xFFFF; code++) {
+        code_error = fmax(code_error, fabs(temperature_centi_from_code(code) - exact_centi(code)));
+    }
+
+    double fixed_error = 0.0, float_error = 0.0, difference = 0.0;
+    for (uint16_t raw = 0; raw < 4096; raw++) {
+        double exact = exact_centi((uint32_t)raw << 4);
+        int32_t fixed = temperature_centi_from_raw(raw);
+        double old = float_temperature(raw) * 100.0;
+        fixed_error = fmax(fixed_error, fabs(fixed - exact));
+        float_error = fmax(float_error, fabs(old - exact));
+        difference = fmax(difference, fabs(fixed - old));
+    }
+
+    printf("erro máximo contra a reta em double (centésimos de grau)\n");
+    printf("  ponto fixo, 65536 códigos de 16 bits: %.3f\n", code_error);
+    printf("  ponto fixo, 4096 leituras de 12 bits: %.3f\n", fixed_error);
+    printf("  float,      4096 leituras de 12 bits: %.3f\n", float_error);
+    printf("  diferença ponto fixo - float:         %.3f\n", difference);
+
+    // O resultado é inteiro em centésimos: o arredondamento sozinho já custa até 0,5
+    check(code_error <= 0.6);
+    check(fixed_error <= 0.6);
+    check(difference <= 0.6);
+}
+
+static void bench_conversion(void) {
+    static uint16_t raws[256];
+    for (int i = 0; i < (int)count_of(raws); i++) {
+        raws[i] = (uint16_t)(850 + i * 7 % 200); // Em torno de 0,7 V (~25 °C)
+    }
+
+    volatile int32_t fixed_sink = 0;
+    uint64_t start = pico_host_cycles();
+    for (int i = 0; i < conversion_repeats; i++) {
+        fixed_sink += temperature_centi_from_raw(raws[i & 255]);
+    }
+    double fixed_cycles = (double)(pico_host_cycles() - start) / conversion_repeats;
+
+    volatile float float_sink = 0.0f;
+    start = pico_host_cycles();
+    for (int i = 0; i < conversion_repeats; i++) {
+        float_sink += float_temperature(raws[i & 255]);
+    }
+    double float_cycles = (double)(pico_host_cycles() - start) / conversion_repeats;
+
+    printf("ciclos por conversão no PC: ponto fixo %.1f, float %.1f (%.2fx)\n",
+           fixed_cycles, float_cycles, float_cycles / fixed_cycles);
+}
+
+static void check_filter(void) {
+    temperature_filter_t filter;
+    temperature_filter_init(&filter, temperature_filter_shift_default);
+
+    // A primeira amostra inicializa a saída, sem rampa a partir de 0
+    check(temperature_filter_update(&filter, 2512) == 2512);
+
+    // Entrada constante: a saída não deriva
+    int drifted = 0;
+    for (int i = 0; i < 10000; i++) {
+        drifted += temperature_filter_update(&filter, 2512) != 2512;
+    }
+    check(drifted == 0);
+
+    // Degraus para cima e para baixo contra o mesmo IIR em double: y += (x - y) / 2^shift
+    static const int32_t steps[] = {3000, -1050, 2512};
+    double reference = 2512.0, max_error = 0.0;
+    for (size_t s = 0; s < count_of(steps); s++) {
+        int32_t output = 0;
+        for (int i = 0; i < 2000; i++) {
+            output = temperature_filter_update(&filter, steps[s]);
+            reference += (steps[s] - reference) / (1 << temperature_filter_shift_default);
+            max_error = fmax(max_error, fabs(output - reference));
+        }
+        check(output == steps[s]); // Sem erro de regime
+    }
+    printf("filtro: erro máximo contra o IIR em double: %.3f centésimos\n", max_error);
+    check(max_error <= 1.0);
+}
+
+// Grava um registro de calibração como temperature_calibrate: magic, ajuste e ~ajuste
+static void program_record(int32_t offset, uint32_t check_word) {
+    uint8_t page[FLASH_PAGE_SIZE];
+    uint32_t record[3] = {calibration_magic, (uint32_t)offset, check_word};
+    memset(page, 0xFF, sizeof(page));
+    memcpy(page, record, sizeof(record));
+    flash_range_erase(temperature_calibration_flash_offset, FLASH_SECTOR_SIZE);
+    flash_range_program(temperature_calibration_flash_offset, page, FLASH_PAGE_SIZE);
+}
+
+static bool stored_record_is(int32_t offset) {
+    const uint8_t *sector = (const uint8_t *)(XIP_BASE + temperature_calibration_flash_offset);
+    uint32_t record[3];
+    memcpy(record, sector, sizeof(record));
+    for (size_t i = sizeof(record); i < FLASH_SECTOR_SIZE; i++) {
+        if (sector[i] != 0xFF) {
+            return false;
+        }
+    }
+    return record[0] == calibration_magic && record[1] == (uint32_t)offset && record[2] == ~(uint32_t)offset;
+}
+
+static void check_calibration(void) {
+    // Sem o adc_sampler rodando o código sobreamostrado é 0; a conta do ajuste não depende disso
+    int32_t measured = temperature_centi_from_code(0);
+
+    // Flash apagada e registro com a verificação errada: sem ajuste
+    temperature_init(temperature_filter_shift_default);
+    check(temperature_calibration_offset() == 0);
+    check(temperature_read_centi() == measured);
+    program_record(123, 123);
+    temperature_init(temperature_filter_shift_default);
+    check(temperature_calibration_offset() == 0);
+
+    // Registro válido: temperature_init carrega o ajuste
+    program_record(123, ~(uint32_t)123);
+    temperature_init(temperature_filter_shift_default);
+    check(temperature_calibration_offset() == 123);
+    check(temperature_read_centi() == measured + 123);
+
+    // Calibrar grava o novo ajuste por cima do anterior (o setor é apagado antes de programar)
+    check(temperature_calibrate(2500));
+    check(temperature_read_centi() == 2500);
+    check(stored_record_is(2500 - measured));
+    check(temperature_calibrate(-1050));
+    check(temperature_read_centi() == -1050);
+    check(stored_record_is(-1050 - measured));
+}
+
+// Comando "cal" pela serial simulada: leitura em centésimos sem ponto flutuante e gravação
+static void check_command(void) {
+    int32_t centi;
+    check(temperature_parse_centi("25.3", &centi) && centi == 2530);
+    check(temperature_parse_centi("-4", &centi) && centi == -400);
+    check(temperature_parse_centi("27,059", &centi) && centi == 2705); // Casas além da segunda são ignoradas
+    check(temperature_parse_centi("+0.5", &centi) && centi == 50);
+    check(!temperature_parse_centi("", &centi));
+    check(!temperature_parse_centi("-.5", &centi));
+    check(!temperature_parse_centi("25 C", &centi));
+
+    // Linhas parciais esperam o fim de linha; só as linhas "cal ..." gravam
+    pico_host_stdin("cal 31.2");
+    temperature_calibration_poll();
+    check(temperature_read_centi() != 3120);
+    pico_host_stdin("\r\nxyz\ncal 1e3\ncal\n");
+    temperature_calibration_poll();
+    check(temperature_read_centi() == 3120);
+    check(stored_record_is(3120 - temperature_centi_from_code(0)));
+
+    check(temperature_calibration_command("cal -2,5"));
+    check(temperature_read_centi() == -250);
+    check(!temperature_calibration_command("calibrar"));
+}
+
+static void check_format(void) {
+    char text[16];
+    temperature_format(text, sizeof(text), 2512);
+    check(strcmp(text, "25.12") == 0);
+    temperature_format(text, sizeof(text), -305);
+    check(strcmp(text, "-3.05") == 0);
+    temperature_format(text, sizeof(text), -5);
+    check(strcmp(text, "-0.05") == 0);
+
+    check(temperature_round(2549, 10) == 255);
+    check(temperature_round(2550, 100) == 26);
+    check(temperature_round(-2549, 10) == -255);
+    check(temperature_round(-2550, 100) == -26);
+}
+
+int main(void) {
+    check_accuracy();
+    bench_conversion();
+    check_filter();
+    check_calibration();
+    check_command();
+    check_format();
+    return host_test_result();
+}
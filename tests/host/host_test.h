@@ -0,0 +1,27 @@
+#ifndef host_test_h
+#define host_test_h
+
+#include <stdio.h>
+#include "pico_host.h"
+
+// Verificações dos testes no PC: uma falha é relatada e o teste continua; o executável termina
+// com host_test_result(), que devolve o código de saída para o CTest
+
+static int host_test_failures;
+
+#define check(condition) do { \
+    if (!(condition)) { \
+        fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #condition); \
+        host_test_failures++; \
+    } \
+} while (0)
+
+static inline int host_test_result(void) {
+    if (host_test_failures) {
+        fprintf(stderr, "%d verificações falharam\n", host_test_failures);
+        return 1;
+    }
+    return 0;
+}
+
+#endif
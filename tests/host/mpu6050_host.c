@@ -0,0 +1,10 @@
+#include "mpu6050_handler.h"
+
+// Escalas do MPU-6050 nas faixas de Tarefa_3 (±2 g e ±250 °/s), sem o driver I2C: os testes do
+// processamento da Tarefa_3 entregam as amostras cruas direto
+void mpu6050_get_scales(mpu6050_scale_t *accel_mg, mpu6050_scale_t *gyro_mdps) {
+    accel_mg->multiplier = 32000; // 1/16,384 mg por unidade, com shift 19
+    accel_mg->shift = 19;
+    gyro_mdps->multiplier = 31267; // 1000/131 mdps por unidade, com shift 12
+    gyro_mdps->shift = 12;
+}
@@ -0,0 +1,494 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/flash.h"
+#include "hardware/i2c.h"
+#include "hardware/irq.h"
+#include "pico_host.h"
+
+// Implementação no PC das funções do SDK usadas pelas bibliotecas compartilhadas: tempo,
+// interrupções, DMA, I2C, flash e entrada da stdio simulados, e o ADC e os clocks só como configuração
+
+#define host_irq_count 32
+#define host_irq_handlers_max 4 // Rotinas compartilhadas por interrupção
+#define host_i2c_devices_max 4
+#define host_i2c_transaction_max 4096 // Maior transação I2C aceita (bytes)
+
+// ===== TEMPO =====
+
+uint64_t pico_host_time_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+uint64_t pico_host_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return pico_host_time_ns();
+#endif
+}
+
+uint64_t time_us_64(void) {
+    return pico_host_time_ns() / 1000;
+}
+
+// ===== INTERRUPÇÕES =====
+
+static irq_handler_t irq_handlers[host_irq_count][host_irq_handlers_max];
+static bool irq_enabled[host_irq_count];
+static uint32_t irq_pending;
+static bool interrupts_disabled;
+static bool in_interrupt;
+
+// Roda as rotinas das interrupções pendentes e habilitadas, se as interrupções estiverem ligadas.
+// Uma rotina que dispara outra transferência deixa a interrupção pendente de novo e o laço a atende
+static void host_irq_dispatch(void) {
+    if (interrupts_disabled || in_interrupt) {
+        return;
+    }
+
+    in_interrupt = true;
+    for (uint num = 0; num < host_irq_count; num++) {
+        while ((irq_pending & (1u << num)) && irq_enabled[num]) {
+            irq_pending &= ~(1u << num);
+            for (int i = 0; i < host_irq_handlers_max && irq_handlers[num][i]; i++) {
+                irq_handlers[num][i]();
+            }
+        }
+    }
+    in_interrupt = false;
+}
+
+static void host_irq_raise(uint num) {
+    irq_pending |= 1u << num;
+    host_irq_dispatch();
+}
+
+uint32_t save_and_disable_interrupts(void) {
+    uint32_t status = interrupts_disabled;
+    interrupts_disabled = true;
+    return status;
+}
+
+void restore_interrupts(uint32_t status) {
+    interrupts_disabled = status;
+    host_irq_dispatch();
+}
+
+void tight_loop_contents(void) {
+    host_irq_dispatch();
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority) {
+    (void)order_priority;
+    for (int i = 0; i < host_irq_handlers_max; i++) {
+        if (irq_handlers[num][i] == NULL || irq_handlers[num][i] == handler) {
+            irq_handlers[num][i] = handler;
+            return;
+        }
+    }
+    fprintf(stderr, "pico_host: rotinas demais na interrupção %u\n", num);
+    abort();
+}
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    memset(irq_handlers[num], 0, sizeof(irq_handlers[num]));
+    irq_handlers[num][0] = handler;
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    irq_enabled[num] = enabled;
+    host_irq_dispatch();
+}
+
+// ===== I2C =====
+
+static i2c_hw_t i2c_hw[NUM_I2CS] = {
+    {.status = I2C_IC_STATUS_TFE_BITS},
+    {.status = I2C_IC_STATUS_TFE_BITS},
+};
+
+i2c_inst_t i2c0_inst = {&i2c_hw[0], false};
+i2c_inst_t i2c1_inst = {&i2c_hw[1], false};
+
+typedef struct {
+    i2c_inst_t *i2c;
+    uint8_t address;
+    pico_host_i2c_write_t write;
+    void *device;
+} host_i2c_device_t;
+
+static host_i2c_device_t i2c_devices[host_i2c_devices_max];
+
+// Transação em montagem em cada barramento (bytes escritos desde o START)
+static uint8_t i2c_transaction[NUM_I2CS][host_i2c_transaction_max];
+static size_t i2c_length[NUM_I2CS];
+
+void pico_host_i2c_attach(i2c_inst_t *i2c, uint8_t address, pico_host_i2c_write_t write, void *device) {
+    for (int i = 0; i < host_i2c_devices_max; i++) {
+        if (i2c_devices[i].write == NULL) {
+            i2c_devices[i] = (host_i2c_device_t){i2c, address, write, device};
+            return;
+        }
+    }
+    fprintf(stderr, "pico_host: dispositivos I2C demais\n");
+    abort();
+}
+
+void pico_host_i2c_detach_all(void) {
+    memset(i2c_devices, 0, sizeof(i2c_devices));
+    memset(i2c_length, 0, sizeof(i2c_length));
+}
+
+static host_i2c_device_t *host_i2c_find(i2c_inst_t *i2c, uint8_t address) {
+    for (int i = 0; i < host_i2c_devices_max; i++) {
+        if (i2c_devices[i].write && i2c_devices[i].i2c == i2c && i2c_devices[i].address == address) {
+            return &i2c_devices[i];
+        }
+    }
+    return NULL;
+}
+
+// STOP: entrega a transação montada ao dispositivo do endereço
+static void host_i2c_stop(i2c_inst_t *i2c, uint8_t address) {
+    uint index = i2c_get_index(i2c);
+    host_i2c_device_t *device = host_i2c_find(i2c, address);
+    if (device && i2c_length[index] > 0) {
+        device->write(device->device, i2c_transaction[index], i2c_length[index]);
+    }
+    i2c_length[index] = 0;
+}
+
+static void host_i2c_push(i2c_inst_t *i2c, uint8_t byte) {
+    uint index = i2c_get_index(i2c);
+    if (i2c_length[index] == host_i2c_transaction_max) {
+        fprintf(stderr, "pico_host: transação I2C maior que %d bytes\n", host_i2c_transaction_max);
+        abort();
+    }
+    i2c_transaction[index][i2c_length[index]++] = byte;
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    i2c->hw->enable = 1;
+    return baudrate;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    if (host_i2c_find(i2c, addr) == NULL) {
+        return PICO_ERROR_GENERIC;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        host_i2c_push(i2c, src[i]);
+    }
+    if (!nostop) {
+        host_i2c_stop(i2c, addr);
+    }
+    return (int)len;
+}
+
+// Palavra escrita em IC_DATA_CMD (pelo DMA): byte nos bits 0-7, STOP no bit 9. O endereço é o de IC_TAR
+static void host_i2c_data_cmd(i2c_inst_t *i2c, uint32_t word) {
+    uint8_t address = (uint8_t)i2c->hw->tar;
+    if ((word & I2C_IC_DATA_CMD_RESTART_BITS) && i2c_length[i2c_get_index(i2c)] > 0) {
+        host_i2c_stop(i2c, address);
+    }
+
+    host_i2c_push(i2c, (uint8_t)word);
+    if (word & I2C_IC_DATA_CMD_STOP_BITS) {
+        host_i2c_stop(i2c, address);
+    }
+}
+
+// ===== DMA =====
+
+typedef struct {
+    bool claimed;
+    dma_channel_config config;
+    volatile void *write_addr;
+    const volatile void *read_addr;
+    uint32_t transfer_count;
+    bool irq_enabled[2];
+} host_dma_channel_t;
+
+dma_hw_t pico_host_dma_hw;
+static host_dma_channel_t dma_channels[NUM_DMA_CHANNELS];
+static uint32_t dma_ints[2]; // Interrupções pendentes por canal (INTS0 e INTS1)
+
+// Campos de dma_channel_config.ctrl (mesmas posições do registrador CTRL do RP2040)
+#define host_dma_size_lsb 2
+#define host_dma_size_bits (3u << host_dma_size_lsb)
+#define host_dma_incr_read_bits (1u << 4)
+#define host_dma_incr_write_bits (1u << 5)
+#define host_dma_treq_sel_lsb 15
+#define host_dma_treq_sel_bits (0x3fu << host_dma_treq_sel_lsb)
+
+int dma_claim_unused_channel(bool required) {
+    for (int channel = 0; channel < NUM_DMA_CHANNELS; channel++) {
+        if (!dma_channels[channel].claimed) {
+            dma_channels[channel].claimed = true;
+            return channel;
+        }
+    }
+    if (required) {
+        fprintf(stderr, "pico_host: nenhum canal de DMA livre\n");
+        abort();
+    }
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel) {
+    memset(&dma_channels[channel], 0, sizeof(dma_channels[channel]));
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    (void)channel;
+    return (dma_channel_config){
+        .ctrl = (DMA_SIZE_32 << host_dma_size_lsb) | host_dma_incr_read_bits | (DREQ_FORCE << host_dma_treq_sel_lsb),
+    };
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *config, enum dma_channel_transfer_size size) {
+    config->ctrl = (config->ctrl & ~host_dma_size_bits) | ((uint32_t)size << host_dma_size_lsb);
+}
+
+void channel_config_set_read_increment(dma_channel_config *config, bool increment) {
+    config->ctrl = increment ? config->ctrl | host_dma_incr_read_bits : config->ctrl & ~host_dma_incr_read_bits;
+}
+
+void channel_config_set_write_increment(dma_channel_config *config, bool increment) {
+    config->ctrl = increment ? config->ctrl | host_dma_incr_write_bits : config->ctrl & ~host_dma_incr_write_bits;
+}
+
+void channel_config_set_dreq(dma_channel_config *config, uint dreq) {
+    config->ctrl = (config->ctrl & ~host_dma_treq_sel_bits) | ((uint32_t)dreq << host_dma_treq_sel_lsb);
+}
+
+void channel_config_set_chain_to(dma_channel_config *config, uint chain_to) {
+    (void)config;
+    (void)chain_to;
+}
+
+void channel_config_set_ring(dma_channel_config *config, bool write, uint size_bits) {
+    (void)config;
+    (void)write;
+    (void)size_bits;
+}
+
+// Destino ligado a um periférico simulado (IC_DATA_CMD de um I2C), ou NULL se for memória
+static i2c_inst_t *host_dma_i2c_target(volatile void *write_addr) {
+    if (write_addr == &i2c0->hw->data_cmd) {
+        return i2c0;
+    }
+    if (write_addr == &i2c1->hw->data_cmd) {
+        return i2c1;
+    }
+    return NULL;
+}
+
+static void host_dma_run(uint channel, uint32_t transfer_count) {
+    host_dma_channel_t *dma = &dma_channels[channel];
+    uint size = 1u << ((dma->config.ctrl & host_dma_size_bits) >> host_dma_size_lsb);
+    const volatile uint8_t *read = dma->read_addr;
+    volatile uint8_t *write = dma->write_addr;
+    i2c_inst_t *i2c = host_dma_i2c_target(dma->write_addr);
+
+    // Sem conversões do ADC o canal fica armado para sempre
+    if ((dma->config.ctrl & host_dma_treq_sel_bits) >> host_dma_treq_sel_lsb == DREQ_ADC) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < transfer_count; i++) {
+        uint32_t word = 0;
+        memcpy(&word, (const void *)read, size);
+        if (i2c) {
+            host_i2c_data_cmd(i2c, word);
+        }
+        else {
+            memcpy((void *)write, &word, size);
+        }
+
+        if (dma->config.ctrl & host_dma_incr_read_bits) {
+            read += size;
+        }
+        if (dma->config.ctrl & host_dma_incr_write_bits) {
+            write += size;
+        }
+    }
+
+    for (int irq = 0; irq < 2; irq++) {
+        if (dma->irq_enabled[irq]) {
+            dma_ints[irq] |= 1u << channel;
+            host_irq_raise(irq ? DMA_IRQ_1 : DMA_IRQ_0);
+        }
+    }
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+    dma_channels[channel].config = *config;
+    dma_channels[channel].write_addr = write_addr;
+    dma_channels[channel].read_addr = read_addr;
+    dma_channels[channel].transfer_count = transfer_count;
+    if (trigger) {
+        host_dma_run(channel, transfer_count);
+    }
+}
+
+void dma_channel_start(uint channel) {
+    host_dma_run(channel, dma_channels[channel].transfer_count);
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count) {
+    dma_channels[channel].read_addr = read_addr;
+    host_dma_run(channel, transfer_count);
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled) {
+    dma_channels[channel].irq_enabled[0] = enabled;
+}
+
+void dma_channel_set_irq1_enabled(uint channel, bool enabled) {
+    dma_channels[channel].irq_enabled[1] = enabled;
+}
+
+bool dma_channel_get_irq0_status(uint channel) {
+    return dma_ints[0] & (1u << channel);
+}
+
+bool dma_channel_get_irq1_status(uint channel) {
+    return dma_ints[1] & (1u << channel);
+}
+
+void dma_channel_acknowledge_irq0(uint channel) {
+    dma_ints[0] &= ~(1u << channel);
+}
+
+void dma_channel_acknowledge_irq1(uint channel) {
+    dma_ints[1] &= ~(1u << channel);
+}
+
+// ===== ADC E CLOCKS =====
+
+adc_hw_t pico_host_adc_hw;
+static uint adc_selected_input;
+
+void adc_init(void) {
+    memset(&pico_host_adc_hw, 0, sizeof(pico_host_adc_hw));
+    adc_selected_input = 0;
+}
+
+void adc_gpio_init(uint gpio) {
+    (void)gpio;
+}
+
+void adc_select_input(uint input) {
+    assert(input < NUM_ADC_CHANNELS);
+    adc_selected_input = input;
+}
+
+uint adc_get_selected_input(void) {
+    return adc_selected_input;
+}
+
+uint16_t adc_read(void) {
+    return (uint16_t)(adc_hw->result & 0xFFF);
+}
+
+void adc_set_temp_sensor_enabled(bool enable) {
+    (void)enable;
+}
+
+void adc_set_round_robin(uint input_mask) {
+    (void)input_mask;
+}
+
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift) {
+    (void)en;
+    (void)dreq_en;
+    (void)dreq_thresh;
+    (void)err_in_fifo;
+    (void)byte_shift;
+}
+
+void adc_fifo_drain(void) {
+}
+
+void adc_set_clkdiv(float clkdiv) {
+    adc_hw->div = (uint32_t)(clkdiv * 256.0f);
+}
+
+void adc_run(bool run) {
+    (void)run;
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index) {
+    switch (clk_index) {
+    case clk_sys:
+    case clk_peri:
+        return 125000000;
+    case clk_usb:
+    case clk_adc:
+        return 48000000;
+    case clk_rtc:
+        return 46875;
+    default:
+        return 12000000;
+    }
+}
+
+// ===== FLASH =====
+
+uint8_t pico_host_flash[PICO_FLASH_SIZE_BYTES];
+
+// A flash começa apagada, como numa placa nova
+__attribute__((constructor)) static void host_flash_init(void) {
+    memset(pico_host_flash, 0xFF, sizeof(pico_host_flash));
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    assert(flash_offs % FLASH_SECTOR_SIZE == 0 && count % FLASH_SECTOR_SIZE == 0);
+    assert(flash_offs + count <= PICO_FLASH_SIZE_BYTES);
+    memset(&pico_host_flash[flash_offs], 0xFF, count);
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    assert(flash_offs % FLASH_PAGE_SIZE == 0 && count % FLASH_PAGE_SIZE == 0);
+    assert(flash_offs + count <= PICO_FLASH_SIZE_BYTES);
+    for (size_t i = 0; i < count; i++) {
+        pico_host_flash[flash_offs + i] &= data[i];
+    }
+}
+
+int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms) {
+    (void)enter_exit_timeout_ms;
+    func(param);
+    return PICO_OK;
+}
+
+// ===== STDIO =====
+
+static const char *host_stdin = "";
+
+void pico_host_stdin(const char *text) {
+    host_stdin = text;
+}
+
+int getchar_timeout_us(uint32_t timeout_us) {
+    (void)timeout_us;
+    if (*host_stdin == '\0') {
+        return PICO_ERROR_TIMEOUT;
+    }
+    return (unsigned char)*host_stdin++;
+}
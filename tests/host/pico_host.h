@@ -0,0 +1,28 @@
+#ifndef pico_host_h
+#define pico_host_h
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+
+// Funções só do PC: ligam dispositivos simulados ao barramento I2C e medem o tempo dos testes
+
+// Recebe uma transação I2C completa (START ... STOP), sem o byte de endereço
+typedef void (*pico_host_i2c_write_t)(void *device, const uint8_t *data, size_t length);
+
+// Liga um dispositivo ao endereço `address` do barramento; escritas para endereços sem
+// dispositivo falham como um NACK (PICO_ERROR_GENERIC)
+extern void pico_host_i2c_attach(i2c_inst_t *i2c, uint8_t address, pico_host_i2c_write_t write, void *device);
+
+// Desliga todos os dispositivos (entre casos de teste)
+extern void pico_host_i2c_detach_all(void);
+
+// Texto entregue por getchar_timeout_us, como se tivesse chegado pela serial (o ponteiro é guardado)
+extern void pico_host_stdin(const char *text);
+
+// Relógio de alta resolução para os benchmarks, em nanossegundos
+extern uint64_t pico_host_time_ns(void);
+
+// Contador de ciclos da CPU do PC (TSC no x86; nos outros, o mesmo que pico_host_time_ns)
+extern uint64_t pico_host_cycles(void);
+
+#endif
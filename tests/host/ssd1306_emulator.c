@@ -0,0 +1,197 @@
+#include <string.h>
+#include "ssd1306_emulator.h"
+
+// Número de argumentos que seguem cada comando do SSD1306 (os demais não têm argumentos)
+static int ssd1306_emulator_arguments(uint8_t opcode) {
+    switch (opcode) {
+    case ssd1306_set_memory_mode:
+    case ssd1306_set_contrast:
+    case ssd1306_set_charge_pump:
+    case ssd1306_set_mux_ratio:
+    case ssd1306_set_display_offset:
+    case ssd1306_set_display_clock_divide_ratio:
+    case ssd1306_set_precharge:
+    case ssd1306_set_common_pin_configuration:
+    case ssd1306_set_vcomh_deselect_level:
+        return 1;
+    case ssd1306_set_column_address:
+    case ssd1306_set_page_address:
+    case ssd1306_set_vertical_scroll_area:
+        return 2;
+    case ssd1306_set_vertical_horizontal_scroll:
+    case ssd1306_set_vertical_horizontal_scroll | 0x03:
+        return 5;
+    case ssd1306_set_horizontal_scroll:
+    case ssd1306_set_horizontal_scroll | 0x01:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+// Executa um comando completo (opcode seguido dos argumentos)
+static void ssd1306_emulator_execute(ssd1306_emulator_t *panel, const uint8_t *command) {
+    uint8_t opcode = command[0];
+
+    switch (opcode) {
+    case ssd1306_set_memory_mode:
+        panel->memory_mode = command[1] & 0x03;
+        break;
+    case ssd1306_set_column_address:
+        panel->column_start = panel->column = command[1] & 0x7F;
+        panel->column_end = command[2] & 0x7F;
+        break;
+    case ssd1306_set_page_address:
+        panel->page_start = panel->page = command[1] & 0x07;
+        panel->page_end = command[2] & 0x07;
+        break;
+    case ssd1306_set_display:
+    case ssd1306_set_display | 0x01:
+        panel->display_on = opcode & 0x01;
+        break;
+    case ssd1306_set_normal_display:
+    case ssd1306_set_inverse_display:
+        panel->inverse = opcode == ssd1306_set_inverse_display;
+        break;
+    case ssd1306_set_scroll:
+    case ssd1306_set_scroll | 0x01:
+        panel->scrolling = opcode & 0x01;
+        break;
+    default:
+        // Endereçamento por página: 0xB0-0xB7 escolhe a página, 0x00-0x1F a coluna (nibbles)
+        if (opcode >= 0xB0 && opcode <= 0xB7) {
+            panel->page = opcode & 0x07;
+        }
+        else if (opcode <= 0x0F) {
+            panel->column = (panel->column & 0xF0) | opcode;
+        }
+        else if (opcode >= 0x10 && opcode <= 0x17) {
+            panel->column = (panel->column & 0x0F) | ((opcode & 0x07) << 4);
+        }
+        break;
+    }
+}
+
+// Acrescenta um byte ao comando em decodificação e o executa quando os argumentos chegam
+static void ssd1306_emulator_command(ssd1306_emulator_t *panel, uint8_t byte) {
+    panel->command[panel->command_length++] = byte;
+    panel->command_bytes++;
+
+    if (panel->command_length > ssd1306_emulator_arguments(panel->command[0])) {
+        ssd1306_emulator_execute(panel, panel->command);
+        panel->command_length = 0;
+    }
+}
+
+// Grava um byte de dados na posição atual e avança conforme o modo de endereçamento
+static void ssd1306_emulator_data(ssd1306_emulator_t *panel, uint8_t byte) {
+    if (panel->scrolling) {
+        panel->scroll_writes++;
+    }
+    panel->gddram[panel->page][panel->column] = byte;
+    panel->data_bytes++;
+
+    switch (panel->memory_mode) {
+    case 0: // Horizontal: coluna a coluna, passando para a próxima página no fim da janela
+        if (panel->column++ >= panel->column_end) {
+            panel->column = panel->column_start;
+            if (panel->page++ >= panel->page_end) {
+                panel->page = panel->page_start;
+            }
+        }
+        break;
+    case 1: // Vertical: página a página, passando para a próxima coluna no fim da janela
+        if (panel->page++ >= panel->page_end) {
+            panel->page = panel->page_start;
+            if (panel->column++ >= panel->column_end) {
+                panel->column = panel->column_start;
+            }
+        }
+        break;
+    default: // Por página: só a coluna avança, voltando ao início da linha
+        panel->column = (panel->column + 1) & 0x7F;
+        break;
+    }
+}
+
+// Uma transação I2C: sequência de bytes de controle (Co no bit 7, D/C# no bit 6). Com Co = 0 o
+// resto da transação é do tipo indicado; com Co = 1 vem um único byte e depois outro controle
+static void ssd1306_emulator_write(void *device, const uint8_t *data, size_t length) {
+    ssd1306_emulator_t *panel = device;
+    panel->transactions++;
+    panel->bytes += length;
+
+    size_t i = 0;
+    while (i < length) {
+        uint8_t control = data[i++];
+        size_t end = (control & 0x80) && i + 1 < length ? i + 1 : length;
+
+        for (; i < end; i++) {
+            if (control & 0x40) {
+                ssd1306_emulator_data(panel, data[i]);
+            }
+            else {
+                ssd1306_emulator_command(panel, data[i]);
+            }
+        }
+    }
+}
+
+void ssd1306_emulator_attach(ssd1306_emulator_t *panel, i2c_inst_t *i2c, uint8_t address) {
+    memset(panel, 0, sizeof(*panel));
+    panel->memory_mode = 2; // Estado do SSD1306 ao ligar
+    panel->column_end = ssd1306_width - 1;
+    panel->page_end = ssd1306_n_pages - 1;
+    pico_host_i2c_attach(i2c, address, ssd1306_emulator_write, panel);
+}
+
+void ssd1306_emulator_reset_counters(ssd1306_emulator_t *panel) {
+    panel->transactions = 0;
+    panel->bytes = 0;
+    panel->command_bytes = 0;
+    panel->data_bytes = 0;
+    panel->scroll_writes = 0;
+}
+
+bool ssd1306_emulator_pixel(const ssd1306_emulator_t *panel, int x, int y) {
+    return panel->gddram[y / 8][x] >> (y % 8) & 1;
+}
+
+bool ssd1306_emulator_matches(const ssd1306_emulator_t *panel, const ssd1306_t *ssd) {
+    for (int page = 0; page < ssd->pages; page++) {
+        if (memcmp(panel->gddram[page], ssd->ram_buffer + 1 + page * ssd->width, ssd->width) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ssd1306_emulator_write_pbm(const ssd1306_emulator_t *panel, const char *path, int scale) {
+    if (scale < 1 || scale > ssd1306_max_scale) {
+        return false;
+    }
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+
+    int width = ssd1306_width * scale;
+    int height = ssd1306_height * scale;
+    fprintf(file, "P4\n%d %d\n", width, height);
+
+    // P4: linhas de pixels com 8 por byte, o mais à esquerda no bit 7 (1 = preto)
+    uint8_t row[(ssd1306_width * ssd1306_max_scale + 7) / 8];
+    for (int y = 0; y < height; y++) {
+        memset(row, 0, sizeof(row));
+        for (int x = 0; x < width; x++) {
+            bool lit = ssd1306_emulator_pixel(panel, x / scale, y / scale) != panel->inverse;
+            if (lit && panel->display_on) {
+                row[x / 8] |= 0x80 >> (x % 8);
+            }
+        }
+        fwrite(row, 1, (width + 7) / 8, file);
+    }
+
+    return fclose(file) == 0;
+}
@@ -0,0 +1,52 @@
+#ifndef ssd1306_emulator_h
+#define ssd1306_emulator_h
+
+#include <stdio.h>
+#include "ssd1306.h"
+#include "pico_host.h"
+
+// Display SSD1306 simulado para os testes no PC: decodifica as transações I2C (byte de controle
+// 0x00/0x80 para comandos, 0x40/0xC0 para dados) e grava os dados numa GDDRAM virtual de 128x64,
+// seguindo o modo de endereçamento e as janelas de coluna/página configuradas por comando. Conta
+// o tráfego recebido, para medir o custo de barramento de cada quadro
+
+typedef struct {
+    uint8_t gddram[ssd1306_n_pages][ssd1306_width]; // Página a página, bit 0 no topo
+
+    // Estado do controlador
+    uint8_t memory_mode; // 0: horizontal, 1: vertical, 2: por página
+    uint8_t column_start, column_end, page_start, page_end;
+    uint8_t column, page; // Posição da próxima escrita de dados
+    bool display_on;
+    bool inverse;
+    bool scrolling;
+
+    // Comando em decodificação (o opcode e os argumentos podem vir em bytes de controle separados)
+    uint8_t command[8];
+    uint8_t command_length;
+
+    // Tráfego recebido
+    uint32_t transactions;   // Transações I2C (START ... STOP)
+    uint32_t bytes;          // Bytes após o endereço, incluindo os bytes de controle
+    uint32_t command_bytes;  // Bytes de comando (opcodes e argumentos)
+    uint32_t data_bytes;     // Bytes gravados na GDDRAM
+    uint32_t scroll_writes;  // Dados recebidos com a rolagem por hardware ativa (o SSD1306 os corrompe)
+} ssd1306_emulator_t;
+
+// Zera a GDDRAM e o estado e liga o display simulado a um endereço do barramento
+extern void ssd1306_emulator_attach(ssd1306_emulator_t *panel, i2c_inst_t *i2c, uint8_t address);
+
+// Zera os contadores de tráfego
+extern void ssd1306_emulator_reset_counters(ssd1306_emulator_t *panel);
+
+// Pixel (x, y) da GDDRAM (sem a inversão do display)
+extern bool ssd1306_emulator_pixel(const ssd1306_emulator_t *panel, int x, int y);
+
+// Indica se a GDDRAM é igual ao framebuffer da instância (tudo o que foi desenhado chegou ao display)
+extern bool ssd1306_emulator_matches(const ssd1306_emulator_t *panel, const ssd1306_t *ssd);
+
+// Escreve a imagem da tela num arquivo PBM binário (P4), ampliada `scale` vezes (1 a
+// ssd1306_max_scale); pixels acesos saem pretos. Retorna false se o arquivo não pôde ser escrito
+extern bool ssd1306_emulator_write_pbm(const ssd1306_emulator_t *panel, const char *path, int scale);
+
+#endif
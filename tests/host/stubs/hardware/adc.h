@@ -0,0 +1,40 @@
+#ifndef _HARDWARE_ADC_H
+#define _HARDWARE_ADC_H
+
+#include "pico/stdlib.h"
+
+// ADC sem conversões: as funções só guardam a configuração e adc_read devolve adc_hw->result,
+// que o teste pode escrever. O modo contínuo não produz amostras (o canal de DMA com DREQ_ADC
+// fica esperando)
+
+#define NUM_ADC_CHANNELS 5
+#define DREQ_ADC 36
+
+typedef struct {
+    volatile uint32_t cs;
+    volatile uint32_t result;
+    volatile uint32_t fcs;
+    volatile uint32_t fifo;
+    volatile uint32_t div;
+    volatile uint32_t intr;
+    volatile uint32_t inte;
+    volatile uint32_t intf;
+    volatile uint32_t ints;
+} adc_hw_t;
+
+extern adc_hw_t pico_host_adc_hw;
+#define adc_hw (&pico_host_adc_hw)
+
+extern void adc_init(void);
+extern void adc_gpio_init(uint gpio);
+extern void adc_select_input(uint input);
+extern uint adc_get_selected_input(void);
+extern uint16_t adc_read(void);
+extern void adc_set_temp_sensor_enabled(bool enable);
+extern void adc_set_round_robin(uint input_mask);
+extern void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift);
+extern void adc_fifo_drain(void);
+extern void adc_set_clkdiv(float clkdiv);
+extern void adc_run(bool run);
+
+#endif
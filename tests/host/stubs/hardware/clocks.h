@@ -0,0 +1,23 @@
+#ifndef _HARDWARE_CLOCKS_H
+#define _HARDWARE_CLOCKS_H
+
+#include "pico/stdlib.h"
+
+// Clocks nas frequências padrão do SDK (125 MHz no sistema, 48 MHz no USB e no ADC)
+enum clock_index {
+    clk_gpout0 = 0,
+    clk_gpout1,
+    clk_gpout2,
+    clk_gpout3,
+    clk_ref,
+    clk_sys,
+    clk_peri,
+    clk_usb,
+    clk_adc,
+    clk_rtc,
+    CLK_COUNT
+};
+
+extern uint32_t clock_get_hz(enum clock_index clk_index);
+
+#endif
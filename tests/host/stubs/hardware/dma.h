@@ -0,0 +1,72 @@
+#ifndef _HARDWARE_DMA_H
+#define _HARDWARE_DMA_H
+
+#include "pico/stdlib.h"
+
+// DMA simulado: a transferência inteira acontece na chamada que a dispara e, se o canal tiver a
+// interrupção habilitada, DMA_IRQ_0/1 fica pendente como no fim de uma transferência real.
+// Um canal pacejado pelo ADC, que não é simulado, fica armado sem transferir nada; o encadeamento
+// e o anel são aceitos e ignorados, e dma_hw são só registradores em memória
+
+#define NUM_DMA_CHANNELS 12
+
+enum dma_channel_transfer_size {
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2
+};
+
+#define DREQ_FORCE 0x3f
+
+typedef struct {
+    uint32_t ctrl;
+} dma_channel_config;
+
+// Registradores de um canal, na ordem do RP2040 (quatro aliases de quatro palavras)
+typedef struct {
+    volatile uint32_t read_addr;
+    volatile uint32_t write_addr;
+    volatile uint32_t transfer_count;
+    volatile uint32_t ctrl_trig;
+    volatile uint32_t al1_ctrl;
+    volatile uint32_t al1_read_addr;
+    volatile uint32_t al1_write_addr;
+    volatile uint32_t al1_transfer_count_trig;
+    volatile uint32_t al2_ctrl;
+    volatile uint32_t al2_transfer_count;
+    volatile uint32_t al2_read_addr;
+    volatile uint32_t al2_write_addr_trig;
+    volatile uint32_t al3_ctrl;
+    volatile uint32_t al3_write_addr;
+    volatile uint32_t al3_transfer_count;
+    volatile uint32_t al3_read_addr_trig;
+} dma_channel_hw_t;
+
+typedef struct {
+    dma_channel_hw_t ch[NUM_DMA_CHANNELS];
+} dma_hw_t;
+
+extern dma_hw_t pico_host_dma_hw;
+#define dma_hw (&pico_host_dma_hw)
+
+extern int dma_claim_unused_channel(bool required);
+extern void dma_channel_unclaim(uint channel);
+extern dma_channel_config dma_channel_get_default_config(uint channel);
+extern void channel_config_set_transfer_data_size(dma_channel_config *config, enum dma_channel_transfer_size size);
+extern void channel_config_set_read_increment(dma_channel_config *config, bool increment);
+extern void channel_config_set_write_increment(dma_channel_config *config, bool increment);
+extern void channel_config_set_dreq(dma_channel_config *config, uint dreq);
+extern void channel_config_set_chain_to(dma_channel_config *config, uint chain_to);
+extern void channel_config_set_ring(dma_channel_config *config, bool write, uint size_bits);
+extern void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                                  const volatile void *read_addr, uint transfer_count, bool trigger);
+extern void dma_channel_start(uint channel);
+extern void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count);
+extern void dma_channel_set_irq0_enabled(uint channel, bool enabled);
+extern void dma_channel_set_irq1_enabled(uint channel, bool enabled);
+extern bool dma_channel_get_irq0_status(uint channel);
+extern bool dma_channel_get_irq1_status(uint channel);
+extern void dma_channel_acknowledge_irq0(uint channel);
+extern void dma_channel_acknowledge_irq1(uint channel);
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef _HARDWARE_FLASH_H
+#define _HARDWARE_FLASH_H
+
+#include "pico/stdlib.h"
+
+// Flash simulada em memória (pico_host_flash, vista em XIP_BASE): apagar deixa os bytes em 0xFF
+// e programar só zera bits, como numa flash NOR
+
+#define FLASH_PAGE_SIZE (1u << 8)
+#define FLASH_SECTOR_SIZE (1u << 12)
+
+extern void flash_range_erase(uint32_t flash_offs, size_t count);
+extern void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef _HARDWARE_I2C_H
+#define _HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+// I2C simulado: cada transação (até o STOP) é entregue inteira ao dispositivo ligado ao endereço
+// (pico_host_i2c_attach), tanto pelas escritas bloqueantes quanto pelas palavras de IC_DATA_CMD
+// escritas pelo DMA
+
+#define NUM_I2CS 2
+
+#define I2C_IC_DATA_CMD_STOP_BITS _u(0x00000200)
+#define I2C_IC_DATA_CMD_RESTART_BITS _u(0x00000400)
+#define I2C_IC_STATUS_ACTIVITY_BITS _u(0x00000001)
+#define I2C_IC_STATUS_TFE_BITS _u(0x00000004)
+
+// Registradores usados pelas bibliotecas (a ordem não segue o RP2040)
+typedef struct {
+    volatile uint32_t enable;
+    volatile uint32_t tar;
+    volatile uint32_t data_cmd;
+    volatile uint32_t status;
+    volatile uint32_t clr_tx_abrt;
+    volatile uint32_t dma_tdlr;
+} i2c_hw_t;
+
+typedef struct i2c_inst {
+    i2c_hw_t *hw;
+    bool restart_on_next;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst;
+extern i2c_inst_t i2c1_inst;
+
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+static inline uint i2c_get_index(i2c_inst_t *i2c) {
+    return i2c == i2c1 ? 1 : 0;
+}
+
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+    return i2c->hw;
+}
+
+static inline uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) {
+    return 32 + 2 * i2c_get_index(i2c) + (is_tx ? 0 : 1);
+}
+
+extern uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+extern int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+
+#endif
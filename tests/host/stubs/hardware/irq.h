@@ -0,0 +1,22 @@
+#ifndef _HARDWARE_IRQ_H
+#define _HARDWARE_IRQ_H
+
+#include "pico/stdlib.h"
+
+// Números das interrupções do RP2040 usadas pelas bibliotecas
+enum {
+    DMA_IRQ_0 = 11,
+    DMA_IRQ_1 = 12,
+    IO_IRQ_BANK0 = 13,
+    ADC_IRQ_FIFO = 22,
+};
+
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+
+typedef void (*irq_handler_t)(void);
+
+extern void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority);
+extern void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+extern void irq_set_enabled(uint num, bool enabled);
+
+#endif
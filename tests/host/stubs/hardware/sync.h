@@ -0,0 +1,15 @@
+#ifndef _HARDWARE_SYNC_H
+#define _HARDWARE_SYNC_H
+
+#include <stdint.h>
+
+// Interrupções simuladas: com as interrupções desabilitadas as rotinas pendentes esperam, e
+// rodam assim que restore_interrupts volta a habilitá-las
+extern uint32_t save_and_disable_interrupts(void);
+extern void restore_interrupts(uint32_t status);
+
+static inline void __dmb(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef _PICO_BINARY_INFO_H
+#define _PICO_BINARY_INFO_H
+
+// Substituto vazio: no PC não há metadados do binário
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef _PICO_FLASH_H
+#define _PICO_FLASH_H
+
+#include "pico/stdlib.h"
+
+// No PC não há outro núcleo nem XIP para pausar: a função roda direto
+extern int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms);
+
+#endif
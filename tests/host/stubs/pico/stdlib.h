@@ -0,0 +1,43 @@
+#ifndef _PICO_STDLIB_H
+#define _PICO_STDLIB_H
+
+// Substituto do pico/stdlib.h para compilar as bibliotecas compartilhadas no PC (tests/host).
+// Só declara o que as bibliotecas usam; as funções ficam em pico_host.c
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hardware/sync.h"
+
+typedef unsigned int uint;
+
+#define _u(x) x ## u
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+#define PICO_OK 0
+#define PICO_ERROR_GENERIC -1
+#define PICO_ERROR_TIMEOUT -2
+
+// Flash de 2 MB da Pico, simulada em memória (pico_host.c) e vista no endereço XIP_BASE
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+
+extern uint8_t pico_host_flash[PICO_FLASH_SIZE_BYTES];
+#define XIP_BASE ((uintptr_t)pico_host_flash)
+
+// Tempo monotônico do processo
+typedef uint64_t absolute_time_t; // Microssegundos, como no SDK sem PICO_DEBUG
+
+extern uint64_t time_us_64(void);
+
+static inline uint32_t time_us_32(void) {
+    return (uint32_t)time_us_64();
+}
+
+// Entrada da stdio: lê o texto de pico_host_stdin, sem esperar
+extern int getchar_timeout_us(uint32_t timeout_us);
+
+// Espera ativa: atende as interrupções simuladas pendentes (ex.: fim de uma transferência de DMA)
+extern void tight_loop_contents(void);
+
+#endif
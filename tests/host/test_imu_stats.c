@@ -0,0 +1,130 @@
+#include <math.h>
+#include <stdlib.h>
+#include "imu_stats.h"
+#include "host_test.h"
+
+// Estatísticas em janela deslizante da Tarefa_3 contra a conta direta sobre as últimas
+// window_samples amostras, depois de cada amostra: média, mínimo, máximo, desvio e contagem dos
+// sete canais. As rampas e a senoide lenta (1 Hz a ±2 g) produzem sequências monotônicas mais
+// longas que a janela, que enchem as filas do mínimo e do máximo. Antes, os detectores de
+// choque, queda livre e inclinação recebem um evento de cada
+
+#define stats_sample_rate_hz 1000
+#define stats_history 8192 // Amostras guardadas para a conta direta (mais que o fluxo do teste)
+
+static const imu_stats_config_t config = IMU_STATS_DEFAULT_CONFIG;
+
+static int16_t history[IMU_STATS_CHANNELS][stats_history];
+static int samples;
+static unsigned wrong[4]; // Mínimo, máximo, média e desvio/contagem fora do esperado
+
+static const char *const metric_names[] = {"mínimo", "máximo", "média", "desvio/contagem"};
+
+static void feed(int16_t ax, int16_t ay, int16_t az, int16_t gx, int16_t gy, int16_t gz) {
+    const int16_t accel[3] = {ax, ay, az}, gyro[3] = {gx, gy, gz};
+    imu_stats_update(accel, gyro);
+
+    uint32_t magnitude = imu_isqrt32((uint32_t)(ax * ax) + (uint32_t)(ay * ay) + (uint32_t)(az * az));
+    const int16_t values[IMU_STATS_CHANNELS] = {
+        ax, ay, az, gx, gy, gz, magnitude > INT16_MAX ? INT16_MAX : (int16_t)magnitude,
+    };
+    for (int channel = 0; channel < IMU_STATS_CHANNELS; channel++) {
+        history[channel][samples] = values[channel];
+    }
+    samples++;
+}
+
+// Confere a publicação atual contra as últimas amostras guardadas
+static void check_window(void) {
+    imu_stats_publish();
+    imu_stats_summary_t summary;
+    imu_stats_read(&summary);
+
+    int count = samples < config.window_samples ? samples : config.window_samples;
+    for (int channel = 0; channel < IMU_STATS_CHANNELS; channel++) {
+        const int16_t *values = &history[channel][samples - count];
+        int16_t min = INT16_MAX, max = INT16_MIN;
+        int64_t sum = 0, sum_squares = 0;
+        for (int i = 0; i < count; i++) {
+            min = values[i] < min ? values[i] : min;
+            max = values[i] > max ? values[i] : max;
+            sum += values[i];
+            sum_squares += (int32_t)values[i] * values[i];
+        }
+        int64_t mean = (sum >= 0 ? sum + count / 2 : sum - count / 2) / count;
+        double std = sqrt((double)(sum_squares * count - sum * sum) / ((double)count * count));
+
+        const imu_channel_stats_t *stats = &summary.channel[channel];
+        wrong[0] += stats->min != min;
+        wrong[1] += stats->max != max;
+        wrong[2] += stats->mean != mean;
+        wrong[3] += fabs(stats->std - std) > 1.0 || stats->count != count;
+    }
+}
+
+static void check_events(void) {
+    imu_events_t events;
+
+    // 1 g parado em z: a referência da inclinação e nenhum evento
+    for (int i = 0; i < 300; i++) {
+        feed(0, 0, 16384, 0, 0, 0);
+    }
+    imu_stats_publish();
+    imu_stats_read_events(&events);
+    check(events.shocks == 0 && events.free_falls == 0 && events.tilts == 0);
+
+    // Um pico de 2 g é um choque; outro dentro do intervalo de espera não conta
+    feed(0, 0, 32767, 0, 0, 0);
+    feed(0, 0, 16384, 0, 0, 0);
+    feed(0, 0, 32767, 0, 0, 0);
+    for (int i = 0; i < 300; i++) {
+        feed(0, 0, 16384, 0, 0, 0);
+    }
+
+    // Queda livre: |a| perto de 0 por mais de 50 ms, contada uma vez
+    for (int i = 0; i < 120; i++) {
+        feed(100, -100, 200, 0, 0, 0);
+    }
+    for (int i = 0; i < 100; i++) {
+        feed(0, 0, 16384, 0, 0, 0);
+    }
+
+    // Inclinação: a gravidade passa para o eixo x por mais de 500 ms
+    for (int i = 0; i < 800; i++) {
+        feed(16384, 0, 0, 0, 0, 0);
+    }
+    imu_stats_publish();
+    imu_stats_read_events(&events);
+    check(events.shocks == 1);
+    check(events.free_falls == 1);
+    check(events.tilts == 1 && events.tilted);
+}
+
+int main(void) {
+    imu_stats_init(&config, stats_sample_rate_hz);
+    check_events();
+
+    // Rampa de subida no x e de descida no giroscópio x, mais longas que a janela
+    for (int i = 0; i < 2000; i++) {
+        feed(-8000 + 8 * i, 300, 16384, 4000 - 4 * i, 0, -20);
+        check_window();
+    }
+    // Rampa de descida no x
+    for (int i = 0; i < 1000; i++) {
+        feed(8000 - 16 * i, 300, 16384, 0, 0, -20);
+        check_window();
+    }
+    // Balanço de 1 Hz a ±2 g no y: meio período (500 amostras) monotônico de cada vez
+    for (int i = 0; i < 3000; i++) {
+        int16_t shake = (int16_t)lround(32767 * sin(2 * M_PI * i / stats_sample_rate_hz));
+        feed(0, shake, 16384, shake / 8, 0, 0);
+        check_window();
+    }
+
+    printf("%d amostras (janela de %u) conferidas em %d canais\n", samples, config.window_samples, IMU_STATS_CHANNELS);
+    for (int metric = 0; metric < 4; metric++) {
+        printf("  %-16s %u erradas\n", metric_names[metric], wrong[metric]);
+        check(wrong[metric] == 0);
+    }
+    return host_test_result();
+}
@@ -0,0 +1,151 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include "mailbox.h"
+#include "host_test.h"
+
+// Caixas de correio sob concorrência real: um thread escreve sem parar numa caixa e num grupo de
+// caixas enquanto outros leem. Cada valor escrito é derivado do contador da escrita, então o
+// leitor confere que não leu um valor misturado de duas escritas, que a sequência nunca volta e
+// que a sequência lida é a da escrita que gravou o valor (nenhuma escrita se perde nem é lida
+// fora de ordem). No fim, as caixas guardam exatamente a última escrita
+
+#define mailbox_writes 2000000
+#define mailbox_readers 3
+
+// Um valor do tamanho máximo de uma caixa, todo derivado do contador
+typedef struct {
+    uint32_t counter;
+    uint32_t inverse;
+    uint32_t square;
+    uint32_t mixed;
+} box_value_t;
+
+// Grupo com mais bytes do que uma caixa guarda: três caixas (16 + 16 + 8 bytes)
+typedef struct {
+    box_value_t first;
+    box_value_t second;
+    uint32_t counter;
+    uint32_t inverse;
+} group_value_t;
+
+static mailbox_t box = mailbox_initializer(sizeof(box_value_t));
+static mailbox_t group[3] = {
+    mailbox_initializer(sizeof(box_value_t)),
+    mailbox_initializer(sizeof(box_value_t)),
+    mailbox_initializer(2 * sizeof(uint32_t)),
+};
+
+static atomic_bool writing = true;
+
+typedef struct {
+    unsigned reads;
+    unsigned torn;         // Valor misturado de duas escritas
+    unsigned out_of_order; // Sequência menor que a da leitura anterior
+    unsigned mismatched;   // Sequência diferente da escrita que gravou o valor
+    unsigned in_progress;  // Leituras feitas com a escrita em andamento (nem a primeira nem a última)
+} reader_stats_t;
+
+static box_value_t make_value(uint32_t counter) {
+    return (box_value_t){counter, ~counter, counter * counter, counter * 2654435761u};
+}
+
+static bool value_is_consistent(const box_value_t *value) {
+    box_value_t expected = make_value(value->counter);
+    return value->inverse == expected.inverse && value->square == expected.square && value->mixed == expected.mixed;
+}
+
+static bool group_is_consistent(const group_value_t *values) {
+    return value_is_consistent(&values->first) && value_is_consistent(&values->second) &&
+           values->second.counter == (values->first.counter ^ 0x5A5A5A5A) &&
+           values->counter == values->first.counter && values->inverse == ~values->counter;
+}
+
+// Antes da primeira escrita (sequência 0) o valor é o do inicializador, todo zerado
+static bool is_zero(const void *value, size_t size) {
+    const uint8_t *bytes = value;
+    for (size_t i = 0; i < size; i++) {
+        if (bytes[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void *writer(void *unused) {
+    (void)unused;
+    for (uint32_t counter = 1; counter <= mailbox_writes; counter++) {
+        box_value_t value = make_value(counter);
+        mailbox_write(&box, &value);
+
+        group_value_t values = {make_value(counter), make_value(counter ^ 0x5A5A5A5A), counter, ~counter};
+        mailbox_write_group(group, count_of(group), &values);
+    }
+    atomic_store(&writing, false);
+    return NULL;
+}
+
+static void *reader(void *data) {
+    reader_stats_t *stats = data;
+    uint32_t last_box = 0, last_group = 0;
+
+    while (atomic_load(&writing)) {
+        box_value_t value;
+        uint32_t sequence = mailbox_read(&box, &value);
+        stats->torn += sequence ? !value_is_consistent(&value) : !is_zero(&value, sizeof(value));
+        stats->out_of_order += sequence < last_box;
+        stats->mismatched += sequence != value.counter;
+        stats->in_progress += sequence > 0 && sequence < mailbox_writes;
+        last_box = sequence;
+
+        group_value_t values;
+        sequence = mailbox_read_group(group, count_of(group), &values);
+        stats->torn += sequence ? !group_is_consistent(&values) : !is_zero(&values, sizeof(values));
+        stats->out_of_order += sequence < last_group;
+        stats->mismatched += sequence != values.counter;
+        last_group = sequence;
+
+        stats->reads += 2;
+    }
+    return NULL;
+}
+
+int main(void) {
+    // Antes da primeira escrita as caixas já podem ser lidas, com o valor zerado
+    box_value_t value;
+    check(mailbox_read(&box, &value) == 0 && is_zero(&value, sizeof(value)));
+
+    pthread_t writer_thread, reader_threads[mailbox_readers];
+    reader_stats_t stats[mailbox_readers] = {0};
+    for (int i = 0; i < mailbox_readers; i++) {
+        pthread_create(&reader_threads[i], NULL, reader, &stats[i]);
+    }
+    pthread_create(&writer_thread, NULL, writer, NULL);
+
+    pthread_join(writer_thread, NULL);
+    reader_stats_t total = {0};
+    for (int i = 0; i < mailbox_readers; i++) {
+        pthread_join(reader_threads[i], NULL);
+        total.reads += stats[i].reads;
+        total.torn += stats[i].torn;
+        total.out_of_order += stats[i].out_of_order;
+        total.mismatched += stats[i].mismatched;
+        total.in_progress += stats[i].in_progress;
+    }
+
+    printf("%d escritas, %d leitores: %u leituras (%u durante as escritas), %u misturadas, "
+           "%u fora de ordem, %u com sequência errada\n",
+           mailbox_writes, mailbox_readers, total.reads, total.in_progress, total.torn,
+           total.out_of_order, total.mismatched);
+    check(total.torn == 0);
+    check(total.out_of_order == 0);
+    check(total.mismatched == 0);
+
+    // Nenhuma escrita perdida: a caixa e o grupo terminam com a última
+    check(mailbox_read(&box, &value) == mailbox_writes);
+    check(value.counter == mailbox_writes && value_is_consistent(&value));
+    group_value_t values;
+    check(mailbox_read_group(group, count_of(group), &values) == mailbox_writes);
+    check(values.counter == mailbox_writes && group_is_consistent(&values));
+    check(mailbox_sequence(&group[2]) == mailbox_writes);
+    return host_test_result();
+}
@@ -0,0 +1,233 @@
+#include <string.h>
+#include "ssd1306_widget.h"
+#include "ssd1306_emulator.h"
+#include "host_test.h"
+
+// Confere a biblioteca do SSD1306 contra o display simulado: depois de cada envio a GDDRAM tem
+// que ser igual ao framebuffer, com o tráfego esperado para cada tipo de envio
+
+static ssd1306_t display;
+static ssd1306_emulator_t panel;
+
+static void setup(void) {
+    pico_host_i2c_detach_all();
+    ssd1306_emulator_attach(&panel, i2c1, ssd1306_i2c_address);
+    ssd1306_init(&display, ssd1306_width, ssd1306_height, false, ssd1306_i2c_address, i2c1);
+}
+
+static void teardown(void) {
+    free(display.ram_buffer);
+}
+
+// A configuração liga o display em endereçamento horizontal, sem tocar na GDDRAM
+static void test_init(void) {
+    setup();
+    check(panel.display_on);
+    check(panel.memory_mode == 0);
+    check(!panel.scrolling);
+    check(panel.data_bytes == 0);
+    check(panel.command_length == 0); // Nenhum comando ficou pela metade
+    teardown();
+}
+
+// Tela inteira: uma transação de endereçamento (0x00 + 6 comandos) e uma de dados (0x40 + 1024)
+static void test_send_data(void) {
+    setup();
+    ssd1306_draw_string(&display, 3, 5, "Olá, SSD1306");
+    ssd1306_rect(&display, 0, 0, ssd1306_width, ssd1306_height, true);
+    ssd1306_emulator_reset_counters(&panel);
+
+    ssd1306_send_data(&display);
+    check(ssd1306_emulator_matches(&panel, &display));
+    check(panel.transactions == 2);
+    check(panel.bytes == 7 + 1 + ssd1306_buffer_length);
+    check(!ssd1306_is_dirty(&display));
+    teardown();
+}
+
+// Envio das janelas alteradas: só as colunas tocadas de cada página
+static void test_dirty(void) {
+    setup();
+    ssd1306_send_data(&display);
+    ssd1306_emulator_reset_counters(&panel);
+
+    ssd1306_draw_char(&display, 16, 8, 'A'); // Alinhado à página: 8 colunas da página 1
+    render_dirty_on_display(&display);
+    check(ssd1306_emulator_matches(&panel, &display));
+    check(panel.transactions == 2);
+    check(panel.data_bytes == 8);
+
+    // Fora do alinhamento o glifo ocupa duas páginas
+    ssd1306_emulator_reset_counters(&panel);
+    ssd1306_draw_char(&display, 40, 21, 'B');
+    render_dirty_on_display(&display);
+    check(ssd1306_emulator_matches(&panel, &display));
+    check(panel.transactions == 4);
+    check(panel.data_bytes == 16);
+
+    // Sem alterações nada é enviado
+    ssd1306_emulator_reset_counters(&panel);
+    render_dirty_on_display(&display);
+    check(panel.transactions == 0);
+    teardown();
+}
+
+static int flush_callbacks;
+
+static void count_flush(void *user_data) {
+    (*(int *)user_data)++;
+}
+
+// Envio por DMA: as mesmas duas transações, montadas em palavras de IC_DATA_CMD. O display
+// assíncrono fica registrado na biblioteca até o fim do programa, então usa outro barramento
+static void test_async(void) {
+    static ssd1306_t async_display;
+
+    pico_host_i2c_detach_all();
+    ssd1306_emulator_attach(&panel, i2c0, ssd1306_i2c_address);
+    ssd1306_init(&async_display, ssd1306_width, ssd1306_height, false, ssd1306_i2c_address, i2c0);
+    ssd1306_async_init(&async_display);
+    ssd1306_fill_rect(&async_display, 10, 3, 50, 30, true);
+    ssd1306_emulator_reset_counters(&panel);
+
+    render_on_display_async(&async_display, count_flush, &flush_callbacks);
+    ssd1306_flush_wait(&async_display);
+    check(!ssd1306_flush_busy(&async_display));
+    check(flush_callbacks == 1);
+    check(ssd1306_emulator_matches(&panel, &async_display));
+    check(panel.transactions == 2);
+    check(panel.bytes == 7 + 1 + ssd1306_buffer_length);
+
+    // Com a interrupção do DMA atrasada, o segundo quadro espera a vez e o terceiro o substitui:
+    // o callback do substituído é chamado na hora e os outros dois no fim de cada envio
+    flush_callbacks = 0;
+    ssd1306_emulator_reset_counters(&panel);
+    uint32_t status = save_and_disable_interrupts();
+    render_on_display_async(&async_display, count_flush, &flush_callbacks);
+    render_on_display_async(&async_display, count_flush, &flush_callbacks);
+    check(flush_callbacks == 0);
+    render_on_display_async(&async_display, count_flush, &flush_callbacks);
+    check(flush_callbacks == 1);
+    restore_interrupts(status);
+    ssd1306_flush_wait(&async_display);
+    check(flush_callbacks == 3);
+    check(panel.transactions == 4); // O substituído não chega ao barramento
+}
+
+// Com a rolagem por hardware ativa, os envios suspendem a rolagem antes de escrever na GDDRAM
+static void test_scroll(void) {
+    setup();
+    ssd1306_send_data(&display);
+    ssd1306_start_scroll(&display, 2, 2, true, ssd1306_scroll_frames_5, 0);
+    check(panel.scrolling);
+
+    ssd1306_draw_string(&display, 0, 40, "rolando");
+    render_dirty_on_display(&display);
+    check(panel.scroll_writes == 0);
+    check(panel.scrolling);
+    check(ssd1306_emulator_matches(&panel, &display));
+
+    ssd1306_stop_scroll(&display);
+    check(!panel.scrolling);
+    teardown();
+}
+
+// Telas de status: as linhas que não cabem vão juntas para a rolagem por hardware, e os passos
+// por software não enviam mais nada. Texto maior que a GDDRAM, ou conteúdo fixo entre as linhas
+// que rolam, deixa tudo com o software
+static void test_marquee_hardware(void) {
+    ssd1306_widget_t lines[4];
+    static const char *const screens[][4] = {
+        {"ERRO", " no driver Wi-Fi", NULL, "WiFi Nao Conecta"}, // Duas linhas, páginas vazias entre elas
+        {NULL, "Reiniciando agora", NULL, NULL},                  // 17 caracteres: mais que a GDDRAM
+        {" no driver Wi-Fi", NULL, "fixo", "WiFi Nao Conecta"},   // "fixo" rolaria junto
+    };
+
+    setup();
+    for (int screen = 0; screen < (int)count_of(screens); screen++) {
+        ssd1306_clear(&display);
+        for (int i = 0; i < 4; i++) {
+            ssd1306_marquee_init(&lines[i], 5, 16 * i, ssd1306_width - 5);
+            if (screens[screen][i]) {
+                ssd1306_marquee_set(&display, &lines[i], screens[screen][i]);
+            }
+        }
+        ssd1306_send_data(&display);
+
+        bool hardware = ssd1306_marquee_hardware_lines(&display, lines, 4, ssd1306_scroll_frames_3);
+        check(hardware == (screen == 0));
+        check(panel.scrolling == hardware);
+        check(ssd1306_emulator_matches(&panel, &display));
+
+        bool stepped = false;
+        ssd1306_emulator_reset_counters(&panel);
+        for (int i = 0; i < 4; i++) {
+            stepped |= ssd1306_marquee_step(&display, &lines[i], 2);
+        }
+        render_dirty_on_display(&display);
+        check(stepped == !hardware);
+        check(hardware ? panel.transactions == 0 : panel.transactions > 0);
+        check(panel.scroll_writes == 0);
+
+        if (hardware) {
+            ssd1306_stop_scroll(&display);
+        }
+    }
+    teardown();
+}
+
+// Os contadores da própria biblioteca (SSD1306_STATS) batem com o tráfego recebido
+static void test_stats(void) {
+    setup();
+    ssd1306_stats_reset(&display);
+    ssd1306_emulator_reset_counters(&panel);
+
+    ssd1306_send_data(&display);
+    ssd1306_draw_string(&display, 0, 13, "12,5");
+    render_dirty_on_display(&display);
+    ssd1306_command(&display, ssd1306_set_inverse_display);
+
+    ssd1306_stats_t stats;
+    ssd1306_stats_get(&display, &stats);
+    check(stats.bytes == panel.bytes);
+    check(stats.transactions == panel.transactions);
+    check(stats.flushes == 2);
+    check(panel.inverse);
+    teardown();
+}
+
+// A imagem exportada tem o cabeçalho PBM e um bit por pixel
+static void test_pbm(void) {
+    setup();
+    ssd1306_fill_rect(&display, 0, 0, 8, 1, true);
+    ssd1306_send_data(&display);
+
+    char path[] = "test_ssd1306.pbm";
+    check(ssd1306_emulator_write_pbm(&panel, path, 1));
+
+    FILE *file = fopen(path, "rb");
+    char header[16] = {0};
+    uint8_t first = 0;
+    check(file != NULL);
+    if (file) {
+        check(fread(header, 1, 10, file) == 10);
+        check(fread(&first, 1, 1, file) == 1);
+        fclose(file);
+    }
+    check(memcmp(header, "P4\n128 64\n", 10) == 0);
+    check(first == 0xFF);
+    remove(path);
+    teardown();
+}
+
+int main(void) {
+    test_init();
+    test_send_data();
+    test_dirty();
+    test_async();
+    test_scroll();
+    test_marquee_hardware();
+    test_stats();
+    test_pbm();
+    return host_test_result();
+}
@@ -0,0 +1,112 @@
+#include <stdlib.h>
+#include "ssd1306_widget.h"
+#include "ssd1306_emulator.h"
+#include "host_test.h"
+
+// Confere que desenhar e enviar quadros não usa o heap: as únicas alocações da biblioteca são
+// o framebuffer (ssd1306_init) e os buffers de DMA (ssd1306_async_init). As funções de alocação
+// são interceptadas pelo linker (-Wl,--wrap), então só contam as chamadas feitas pelo nosso código
+
+#define alloc_frames 500
+
+static unsigned allocations;
+static unsigned frees;
+
+extern void *__real_malloc(size_t size);
+extern void *__real_calloc(size_t count, size_t size);
+extern void *__real_realloc(void *pointer, size_t size);
+extern void __real_free(void *pointer);
+
+void *__wrap_malloc(size_t size) {
+    allocations++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    allocations++;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *pointer, size_t size) {
+    allocations++;
+    return __real_realloc(pointer, size);
+}
+
+void __wrap_free(void *pointer) {
+    if (pointer) {
+        frees++;
+    }
+    __real_free(pointer);
+}
+
+static ssd1306_t display;
+static ssd1306_emulator_t panel;
+
+// Um quadro de cada tipo de envio, com os widgets e primitivas usados pelas tarefas
+static void draw_frame(int frame, ssd1306_widget_t *value, ssd1306_widget_t *arrow, ssd1306_widget_t *marquee) {
+    ssd1306_value_set(&display, value, 250 + frame % 50);
+    ssd1306_arrow_set(&display, arrow, frame & 1 ? "Cima" : "Baixo", frame & 1 ? ssd1306_arrow_up : ssd1306_arrow_down);
+    ssd1306_marquee_step(&display, marquee, 2);
+    ssd1306_draw_text(&display, &ssd1306_font_text7, 0, 40, "Ação concluída");
+    ssd1306_draw_line(&display, 0, 63, 127, 48 + frame % 16, true);
+    ssd1306_fill_rect(&display, 100, 20, 20, 10, frame & 1);
+}
+
+int main(void) {
+    ssd1306_emulator_attach(&panel, i2c1, ssd1306_i2c_address);
+
+    unsigned before = allocations;
+    ssd1306_init(&display, ssd1306_width, ssd1306_height, false, ssd1306_i2c_address, i2c1);
+    check(allocations - before == 1); // Framebuffer com o byte de controle na frente
+
+    ssd1306_widget_t value, arrow, marquee;
+    ssd1306_value_init_font(&value, 28, 18, 100, 1, "°C", &ssd1306_font_num16);
+    ssd1306_arrow_init(&arrow, 25, 54, 103);
+    ssd1306_marquee_init(&marquee, 0, 0, ssd1306_width);
+    ssd1306_marquee_set(&display, &marquee, "Linha de status mais larga que a tela");
+
+    // Envios bloqueantes: tela inteira, janelas alteradas e janela escolhida
+    before = allocations;
+    unsigned frees_before = frees;
+    for (int frame = 0; frame < alloc_frames; frame++) {
+        draw_frame(frame, &value, &arrow, &marquee);
+        switch (frame % 3) {
+        case 0:
+            ssd1306_send_data(&display);
+            break;
+        case 1:
+            render_dirty_on_display(&display);
+            break;
+        default: {
+            struct render_area area = {.start_column = 8, .end_column = 119, .start_page = 2, .end_page = 5};
+            render_on_display(&display, &area);
+            break;
+        }
+        }
+    }
+    unsigned frame_allocations = allocations - before;
+    unsigned frame_frees = frees - frees_before;
+    check(panel.data_bytes > 0);
+
+    // Envio por DMA: os dois buffers de palavras são reservados uma única vez
+    before = allocations;
+    ssd1306_async_init(&display);
+    check(allocations - before == 2);
+
+    before = allocations;
+    frees_before = frees;
+    for (int frame = 0; frame < alloc_frames; frame++) {
+        draw_frame(frame, &value, &arrow, &marquee);
+        render_on_display_async(&display, NULL, NULL);
+        ssd1306_flush_wait(&display);
+    }
+    frame_allocations += allocations - before;
+    frame_frees += frees - frees_before;
+    check(ssd1306_emulator_matches(&panel, &display));
+
+    printf("%d quadros: %u alocações e %u liberações depois da inicialização\n",
+           2 * alloc_frames, frame_allocations, frame_frees);
+    check(frame_allocations == 0);
+    check(frame_frees == 0);
+    return host_test_result();
+}